@@ -0,0 +1,57 @@
+TEMPLATE = app
+CONFIG += console c++17 thread
+CONFIG -= app_bundle
+CONFIG -= qt
+
+HEADERS += \
+    headers/earth.h \
+    headers/geometry.h \
+    headers/logs.h \
+    headers/position.h \
+    headers/route.h \
+    headers/loadstats.h \
+    headers/memo.h \
+    headers/sparsetable.h \
+    headers/trace.h \
+    headers/track.h \
+    headers/routecollection.h \
+    headers/types.h \
+    headers/allocationcounter.h \
+    headers/xmlparser.h \
+    headers/xmlgenerator.h \
+    headers/nmeagenerator.h \
+    headers/gridworld.h \
+    headers/gridworld_route.h \
+    headers/gridworld_track.h \
+    headers/workload.h
+
+SOURCES += \
+    src/earth.cpp \
+    src/geometry.cpp \
+    src/logs.cpp \
+    src/allocationcounter.cpp \
+    src/position.cpp \
+    src/route.cpp \
+    src/trace.cpp \
+    src/track.cpp \
+    src/routecollection.cpp \
+    src/xmlparser.cpp \
+    src/xmlgenerator.cpp \
+    src/nmeagenerator.cpp \
+    src/gridworld.cpp \
+    src/gridworld_route.cpp \
+    src/gridworld_track.cpp \
+    src/workload.cpp \
+    src/gpx-bench.cpp
+
+INCLUDEPATH += headers/
+
+QMAKE_CXXFLAGS_RELEASE += -O2
+
+# Record load timings in Route and Track build reports (see loadstats.h).
+DEFINES += GPS_LOAD_TIMINGS
+
+# Compile in the trace spans (see trace.h); recording is still off until enabled at runtime.
+DEFINES += GPS_TRACING
+
+TARGET = $$_PRO_FILE_PWD_/execs/gpx-bench
@@ -0,0 +1,33 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+HEADERS += \
+    headers/earth.h \
+    headers/geometry.h \
+    headers/logs.h \
+    headers/position.h \
+    headers/route.h \
+    headers/loadstats.h \
+    headers/memo.h \
+    headers/sparsetable.h \
+    headers/trace.h \
+    headers/track.h \
+    headers/types.h \
+    headers/xmlparser.h
+
+SOURCES += \
+    src/earth.cpp \
+    src/geometry.cpp \
+    src/logs.cpp \
+    src/position.cpp \
+    src/route.cpp \
+    src/trace.cpp \
+    src/track.cpp \
+    src/xmlparser.cpp \
+    src/gpx-memory.cpp
+
+INCLUDEPATH += headers/
+
+TARGET = $$_PRO_FILE_PWD_/execs/gpx-memory
@@ -1,5 +1,5 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
@@ -9,13 +9,22 @@ HEADERS += \
     headers/logs.h \
     headers/position.h \
     headers/route.h \
+    headers/loadstats.h \
+    headers/memo.h \
+    headers/sparsetable.h \
+    headers/trace.h \
     headers/track.h \
+    headers/routecollection.h \
+    headers/routesnapshot.h \
     headers/types.h \
+    headers/allocationcounter.h \
     headers/xmlparser.h \
     headers/xmlgenerator.h \
+    headers/nmeagenerator.h \
     headers/gridworld.h \
     headers/gridworld_route.h \
     headers/gridworld_track.h \
+    headers/workload.h \
     headers/accessOperatorLogGenerator.h
 
 SOURCES += \
@@ -23,14 +32,20 @@ SOURCES += \
     src/gpx-tests.cpp \
     src/geometry.cpp \
     src/logs.cpp \
+    src/allocationcounter.cpp \
     src/position.cpp \
     src/route.cpp \
+    src/trace.cpp \
     src/track.cpp \
+    src/routecollection.cpp \
+    src/routesnapshot.cpp \
     src/xmlparser.cpp \
     src/xmlgenerator.cpp \
+    src/nmeagenerator.cpp \
     src/gridworld.cpp \
     src/gridworld_route.cpp \
     src/gridworld_track.cpp \
+    src/workload.cpp \
     src/gpx-tests/name.cpp \
     src/gpx-tests/numpositions.cpp \
     # src/gpx-tests/minLatitudeN0727890.cpp \
@@ -77,7 +92,23 @@ SOURCES += \
     src/gpx-tests/maxelevation-N0749364.cpp \
     # src/gpx-tests/restingTime-N0747947.cpp \
     src/gpx-tests/MinimumElevationTests-N0749369.cpp\
-    src/gpx-tests/findPositionN0704377.cpp
+    src/gpx-tests/findPositionN0704377.cpp \
+    src/gpx-tests/gridworldTrackToGPX.cpp \
+    src/gpx-tests/gridworld.cpp \
+    src/gpx-tests/gridworldToRouteAndTrack.cpp \
+    src/gpx-tests/loadStats.cpp \
+    src/gpx-tests/memoryUsage.cpp \
+    src/gpx-tests/zeroAllocationQueries.cpp \
+    src/gpx-tests/trace.cpp \
+    src/gpx-tests/routeCollection.cpp \
+    src/gpx-tests/parallelParse.cpp \
+    src/gpx-tests/peakMemory.cpp \
+    src/gpx-tests/routeSnapshot.cpp \
+    src/gpx-tests/memoisedStatistics.cpp \
+    src/gpx-tests/rangeQueries.cpp \
+    src/gpx-tests/rangeIndex.cpp \
+    src/gpx-tests/positionAt.cpp \
+    src/gpx-tests/workload.cpp
     # src/gpx-tests/totalheightgain-n0673737.cpp
 
     # src/gpx-tests/totalTimeN0774540.cpp \
@@ -94,6 +125,9 @@ SOURCES += \
 
 INCLUDEPATH += headers/
 
+# Compile in the trace spans (see trace.h); recording is still off until enabled at runtime.
+DEFINES += GPS_TRACING
+
 TARGET = $$_PRO_FILE_PWD_/execs/gpx-tests
 
 LIBS += -lboost_unit_test_framework
@@ -0,0 +1,28 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+HEADERS += \
+    headers/earth.h \
+    headers/geometry.h \
+    headers/logs.h \
+    headers/parseNMEA.h \
+    headers/trace.h \
+    headers/position.h \
+    headers/types.h
+
+SOURCES += \
+    src/earth.cpp \
+    src/geometry.cpp \
+    src/logs.cpp \
+    src/position.cpp \
+    src/parseNMEA.cpp \
+    src/trace.cpp \
+    src/nmea-bench.cpp
+
+INCLUDEPATH += headers/
+
+QMAKE_CXXFLAGS_RELEASE += -O2
+
+TARGET = $$_PRO_FILE_PWD_/execs/nmea-bench
@@ -1,5 +1,5 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
@@ -9,17 +9,42 @@ HEADERS += \
     headers/logs.h \
     headers/parseNMEA.h \
     headers/position.h \
-    headers/types.h
+    headers/route.h \
+    headers/loadstats.h \
+    headers/memo.h \
+    headers/sparsetable.h \
+    headers/trace.h \
+    headers/track.h \
+    headers/types.h \
+    headers/xmlparser.h \
+    headers/xmlgenerator.h \
+    headers/nmeagenerator.h \
+    headers/gridworld.h \
+    headers/gridworld_route.h \
+    headers/gridworld_track.h
 
 SOURCES += \
     src/earth.cpp \
     src/geometry.cpp \
     src/logs.cpp \
     src/position.cpp \
+    src/route.cpp \
+    src/trace.cpp \
+    src/track.cpp \
+    src/parseNMEA.cpp \
+    src/xmlparser.cpp \
+    src/xmlgenerator.cpp \
+    src/nmeagenerator.cpp \
+    src/gridworld.cpp \
+    src/gridworld_route.cpp \
+    src/gridworld_track.cpp \
     src/nmea-tests.cpp 
 
 INCLUDEPATH += headers/
 
+# Compile in the trace spans (see trace.h); recording is still off until enabled at runtime.
+DEFINES += GPS_TRACING
+
 TARGET = $$_PRO_FILE_PWD_/execs/nmea-tests
 
 LIBS += -lboost_unit_test_framework
@@ -0,0 +1,44 @@
+TEMPLATE = app
+CONFIG += console c++17 thread
+CONFIG -= app_bundle
+CONFIG -= qt
+
+HEADERS += \
+    headers/earth.h \
+    headers/geometry.h \
+    headers/position.h \
+    headers/route.h \
+    headers/loadstats.h \
+    headers/memo.h \
+    headers/sparsetable.h \
+    headers/trace.h \
+    headers/track.h \
+    headers/types.h \
+    headers/xmlparser.h \
+    headers/xmlgenerator.h \
+    headers/nmeagenerator.h \
+    headers/gridworld.h \
+    headers/gridworld_track.h \
+    headers/workload.h
+
+SOURCES += \
+    src/earth.cpp \
+    src/geometry.cpp \
+    src/position.cpp \
+    src/route.cpp \
+    src/trace.cpp \
+    src/track.cpp \
+    src/xmlparser.cpp \
+    src/xmlgenerator.cpp \
+    src/nmeagenerator.cpp \
+    src/gridworld.cpp \
+    src/gridworld_route.cpp \
+    src/gridworld_track.cpp \
+    src/workload.cpp \
+    src/workload-main.cpp
+
+INCLUDEPATH += headers/
+
+QMAKE_CXXFLAGS_RELEASE += -O2
+
+TARGET = $$_PRO_FILE_PWD_/execs/workload-generator
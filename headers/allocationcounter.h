@@ -0,0 +1,46 @@
+#ifndef ALLOCATIONCOUNTER_H_120218
+#define ALLOCATIONCOUNTER_H_120218
+
+#include <cstddef>
+
+namespace GPS
+{
+  /* Counts heap allocations made by the current thread, and measures peak heap usage, for tests
+   * and benchmarks.
+   *
+   * Linking allocationcounter.cpp into an executable replaces the global operator new and
+   * operator delete with versions that count every allocation (and are otherwise equivalent
+   * to the defaults), so only link it into test and benchmark executables.
+   *
+   * E.g.
+   *     AllocationCounter counter;
+   *     route.maxGradient();
+   *     BOOST_CHECK_EQUAL( counter.allocations(), 0 );
+   */
+  class AllocationCounter
+  {
+    public:
+      AllocationCounter();
+
+      // The number of allocations made by this thread since construction.
+      std::size_t allocations() const;
+
+      // The number of allocations made by this thread since it started.
+      static std::size_t threadAllocations();
+
+      /* The most heap memory (in bytes, excluding allocator overheads) in use at any time since
+       * construction, beyond what was in use at construction.  Heap usage is process-wide, and
+       * constructing an AllocationCounter resets the peak, so only one should measure it at a time.
+       */
+      std::size_t peakBytes() const;
+
+      // The heap memory (in bytes) currently in use, by all threads.
+      static std::size_t liveBytes();
+
+    private:
+      std::size_t startCount;
+      std::size_t startBytes;
+  };
+}
+
+#endif
@@ -1,7 +1,8 @@
 #ifndef GRIDWORLD_H_211217
 #define GRIDWORLD_H_211217
 
-#include <map>
+#include <string>
+#include <vector>
 
 #include "types.h"
 #include "position.h"
@@ -21,6 +22,11 @@ namespace GPS
    *  Up/down in the grid changes latitude relative to M.
    *  Left/right in the grid changes longitude relative to M.
    *  Note: the closer you get to a pole, the more distorted from a grid this becomes.
+   *
+   *  Larger grids of any number of rows and columns can also be constructed.  Their points
+   *  are addressed by (row,column) Coordinates, counted from 0 at the top left; the central
+   *  point (rows/2,columns/2) takes the role of M.  The A-Y names are the special case of the
+   *  standard 5x5 grid, where e.g. 'M' is (2,2).
    */
 
   class GridWorld
@@ -29,21 +35,95 @@ namespace GPS
       using Point = char;
       static const int gridSize;
 
+      struct Coordinates
+      {
+          unsigned int row;
+          unsigned int column;
+      };
+
       // Defaults to Pontianak, the only equatorial city.
       GridWorld(const Position & posM = Earth::Pontianak, // Position of the central point 'M'.
                 metres horizontalGridUnit = 10000, // Horizontal distance between grid points.
                 metres verticalGridUnit = 0); // Vertical distance between grid levels.
 
+      // A grid of any size.  Throws a std::invalid_argument exception if either dimension is zero.
+      GridWorld(unsigned int rows,
+                unsigned int columns,
+                const Position & posCentre = Earth::Pontianak, // Position of the central point (rows/2,columns/2).
+                metres horizontalGridUnit = 10000,
+                metres verticalGridUnit = 0);
+
+      /* Construct a GridWorld from the angular distances between grid points, rather than
+       * horizontal distances in metres.  No trigonometry is involved, so callers with
+       * compile-time-known grid units pay only for the arithmetic of laying out the grid.
+       */
+      static GridWorld fromAngularUnits(const Position & posCentre,
+                                        degrees latitudeGridUnit, // Latitude difference between grid rows.
+                                        degrees longitudeGridUnit, // Longitude difference between grid columns.
+                                        metres verticalGridUnit = 0,
+                                        unsigned int rows = gridSize,
+                                        unsigned int columns = gridSize);
+
+      unsigned int rows() const;
+      unsigned int columns() const;
+
+      // Constant time.  Throws a std::out_of_range exception for Points outside A-Y, or if this is not a 5x5 grid.
       const Position& operator[](Point) const;
 
+      // Whether this is the standard 5x5 grid, the only one whose points can be referred to as A-Y.
+      bool isStandardGrid() const;
+
+      // Whether the Coordinates lie within this grid.
+      bool contains(Coordinates) const;
+
+      // Constant time.  Throws a std::out_of_range exception for Coordinates outside the grid.
+      const Position& operator[](Coordinates) const;
+
+      /* Replace the elevation of a single grid point, e.g. to add terrain noise.
+       * Throws a std::out_of_range exception for Coordinates outside the grid.
+       */
+      void setElevation(Coordinates, metres);
+
+      // The coordinates of a Point A-Y in the standard 5x5 grid.
+      static Coordinates coordinatesOf(Point);
+
+      /* Route and track strings refer to points either by a single character A-Y, or as
+       * "(row,column)", e.g. "(12,40)".  This reads one such reference starting at index "pos"
+       * of "str", and advances "pos" past it.  Returns false (leaving "pos" unchanged) if there
+       * is no well-formed reference at "pos".  A-Y references are only meaningful in a 5x5 grid
+       * (see isStandardGrid()); this does not check which grid they are for.
+       */
+      static bool readPoint(const std::string & str, std::size_t & pos, Coordinates & coords);
+
+      // The name of a point: its A-Y character in a 5x5 grid, otherwise "(row,column)".
+      std::string nameOf(Coordinates) const;
+
+      // The maximum number of characters written by formatName(), e.g. "(4294967295,4294967295)".
+      static const std::size_t maxNameLength = 23;
+
+      /* Writes the same text as nameOf() into a buffer with room for at least maxNameLength
+       * characters, without allocating.  Returns a pointer one past the last character written.
+       */
+      char * formatName(char * buffer, Coordinates) const;
+
     private:
-      std::map<Point,Position> grid;
+      unsigned int numRows;
+      unsigned int numColumns;
+
+      // Indexed by (row * columns + column); for the 5x5 grid this is (point - 'A').
+      std::vector<Position> grid;
+
+      struct AngularUnits {};
+      GridWorld(AngularUnits, const Position & posCentre, degrees deltaLat, degrees deltaLon, metres verticalGridUnit,
+                unsigned int rows, unsigned int columns);
+
 
-      /* The first parameter is the grid Point.
-       * The second parameter is the elevation of Point M.
+      /* The first parameter is the distance (in grid steps, horizontally or vertically,
+       * whichever is greater) of the grid point from the central point.
+       * The second parameter is the elevation of the central point.
        * The third parameter is the vertical distance between grid points.
        */
-      static metres calcElevationFor(Point point, metres eleM, metres verticalGridUnit);
+      static metres calcElevationFor(unsigned int stepsFromCentre, metres eleCentre, metres verticalGridUnit);
   };
 
   // Ensure lat/lon are within range after local modifications.
@@ -2,8 +2,10 @@
 #define GRIDWORLD_ROUTE_H_120218
 
 #include <string>
+#include <vector>
 
 #include "gridworld.h"
+#include "route.h"
 
 namespace GPS
 {
@@ -11,6 +13,7 @@ namespace GPS
    *
    * To use this class, the user must provide a string of GridWorld::Points
    * specifying the route path, e.g. "ABCD".
+   * In GridWorlds of other sizes, points are written as "(row,column)", e.g. "(0,0)(0,1)(5,7)".
    * The locations of these points are interpreted in a GridWorld (see GridWorld.h).
    * The user may provide a GridWorld object; if not the default GridWorld is used.
    */
@@ -24,8 +27,14 @@ namespace GPS
       std::string toGPX(bool embedName = true, // Whether a <name> element should be included in the generated GPX file.
                         const std::string& routeName = "") const; // Contents of <name> element.  If empty, defaults to the route string.
 
-      // Produce a NMEA representation of the route.
-      std::string toNMEA() const; // unimplemented
+      /* Produce the Route that parsing the GPX representation would, but directly from the
+       * GridWorld Positions (which are therefore not rounded to the precision of the GPX text).
+       */
+      Route toRoute(metres granularity = 20, // See Route.
+                    const std::string& routeName = "") const; // If empty, defaults to the route string.
+
+      // Produce a NMEA representation of the route, as one GGA sentence per point.
+      std::string toNMEA() const;
 
       // Produce a string representation of the track.
       std::string toString() const;
@@ -36,6 +45,7 @@ namespace GPS
     private:
       const std::string routeString;
       const GridWorld gridworld;
+      std::vector<GridWorld::Coordinates> waypoints;
   };
 }
 #endif
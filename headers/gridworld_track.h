@@ -5,6 +5,8 @@
 #include <vector>
 
 #include "gridworld.h"
+#include "xmlgenerator.h"
+#include "track.h"
 
 namespace GPS
 {
@@ -14,6 +16,7 @@ namespace GPS
  * interspersed with time units, specifying the track path and times.
  * E.g. "A1B3C" means that it takes 1 time unit to travel from Point A to Point B,
  * then 3 time units to travel from Point B to Point C.
+ * In GridWorlds of other sizes, points are written as "(row,column)", e.g. "(0,0)1(0,1)3(1,1)".
  *
  * The locations of these points are interpreted in a GridWorld (see GridWorld.h).
  * The user may provide a GridWorld object; if not the default GridWorld is used.
@@ -29,10 +32,37 @@ namespace GPS
       // Produce a GPX representation of the track.
       std::string toGPX(seconds logInterval, // Time interval between generated tracking points.
                         bool embedName = true, // Whether a <name> element should be included in the generated GPX file.
-                        const std::string& trackName = "") const; // Contents of <name> element.  If empty, defaults to the track string.
+                        const std::string& trackName = "", // Contents of <name> element.  If empty, defaults to the track string.
+                        bool compact = false, // Omit indentation and newlines.
+                        unsigned int threads = 1) const; // Generate track segments in parallel (0 for one thread per core); the output is the same.
 
-      // Produce a NMEA representation of the track.
-      std::string toNMEA(seconds logInterval) const; // unimplemented
+      /* As above, but write the GPX through a Sink (see XML::Generator) rather than returning it,
+       * so that long tracks with short logging intervals can be exported in constant memory.
+       */
+      void toGPX(XML::Generator::Sink sink,
+                 seconds logInterval,
+                 bool embedName = true,
+                 const std::string& trackName = "",
+                 bool compact = false,
+                 unsigned int threads = 1) const;
+
+      /* Produce the Track that parsing the GPX representation would, but directly from the
+       * generated Positions (which are therefore not rounded to the precision of the GPX text).
+       */
+      Track toTrack(seconds logInterval,
+                    metres granularity = 10, // See Track.
+                    const std::string& trackName = "") const; // If empty, defaults to the track string.
+
+      /* Produce a NMEA representation of the track, as a GGA, an RMC and a GLL sentence per tracking point.
+       * Only the GGA sentence includes the elevation.
+       */
+      std::string toNMEA(seconds logInterval) const;
+
+      /* As above, but stream the sentences to an open file descriptor through a fixed-size buffer,
+       * so that arbitrarily long tracks can be written in constant memory.
+       * Throws a std::runtime_error if writing fails.
+       */
+      void toNMEA(seconds logInterval, int fileDescriptor) const;
 
       // Produce a string representation of the track.
       std::string toString() const;
@@ -49,10 +79,25 @@ namespace GPS
       const seconds timeUnitDuration;
       const seconds startTime;
 
-      std::vector<GridWorld::Point> waypoints;
+      std::vector<GridWorld::Coordinates> waypoints;
       std::vector<unsigned int> timeUnitsToNextWaypoint;
 
       void constructWaypoints();
+
+      void writeGPX(XML::Generator& gpx, seconds logInterval, bool embedName, const std::string& trackName, unsigned int threads) const;
+
+      // Write the trkseg element from waypoints[segment] to waypoints[segment+1].
+      void writeSegment(XML::Generator& gpx, std::size_t segment, seconds segmentStartTime, seconds logInterval) const;
+
+      void writeSegmentsInParallel(XML::Generator& gpx, seconds logInterval, unsigned int threads) const;
+
+      // Calls visit(position,time) for each tracking point, in the order they appear in the GPX.
+      template <typename PointVisitor>
+      void forEachPoint(seconds logInterval, PointVisitor visit) const;
+
+      // Calls visit(sentence,length) for each NMEA sentence in the track.
+      template <typename SentenceVisitor>
+      void forEachNMEASentence(seconds logInterval, SentenceVisitor visit) const;
   };
 }
 
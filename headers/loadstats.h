@@ -0,0 +1,53 @@
+#ifndef LOADSTATS_H_120218
+#define LOADSTATS_H_120218
+
+#include <chrono>
+#include <cstddef>
+
+namespace GPS
+{
+  /* Statistics about the construction of a Route or Track.
+   *
+   * The counters are always recorded.  The timings are only recorded when compiled with
+   * GPS_LOAD_TIMINGS defined (e.g. "DEFINES += GPS_LOAD_TIMINGS" in the .pro file), and
+   * are otherwise zero.
+   */
+  struct LoadStats
+  {
+#ifdef GPS_LOAD_TIMINGS
+      static constexpr bool timingsEnabled = true;
+#else
+      static constexpr bool timingsEnabled = false;
+#endif
+
+      std::chrono::nanoseconds readFile {0};
+      std::chrono::nanoseconds setupFileData {0}; // Locating the root elements.
+      std::chrono::nanoseconds pointLoop {0}; // Extracting, constructing and filtering each point.
+      std::chrono::nanoseconds setRouteLength {0};
+      std::chrono::nanoseconds buildRangeIndex {0}; // If requested, after construction.
+
+      std::size_t pointsSeen = 0;
+      std::size_t pointsAccepted = 0;
+      std::size_t pointsIgnored = 0; // Too close to the previous point.
+      std::size_t bytesScanned = 0; // Length of the GPX data.
+
+      // Adds the time from construction to destruction to a timing, if timings are enabled.
+      class PhaseTimer
+      {
+        public:
+#ifdef GPS_LOAD_TIMINGS
+          explicit PhaseTimer(std::chrono::nanoseconds & timing)
+            : timing{timing}, start{std::chrono::steady_clock::now()} {}
+          ~PhaseTimer() { timing += std::chrono::steady_clock::now() - start; }
+
+        private:
+          std::chrono::nanoseconds & timing;
+          std::chrono::steady_clock::time_point start;
+#else
+          explicit PhaseTimer(std::chrono::nanoseconds &) {}
+#endif
+      };
+  };
+}
+
+#endif
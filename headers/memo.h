@@ -0,0 +1,39 @@
+#ifndef MEMO_H_120218
+#define MEMO_H_120218
+
+#include <atomic>
+#include <mutex>
+
+namespace GPS
+{
+  /* A value computed on first use, and then remembered.
+   *
+   * Any number of threads may call get() concurrently: the value is computed exactly once, by one of
+   * them, and the others wait for it.  If the computation throws, the exception is passed on and
+   * the next call tries again.  A Memo cannot be reset; discard it and use a new one instead.
+   */
+  template <typename T>
+  class Memo
+  {
+    public:
+      template <typename Compute>
+      const T & get(Compute compute) const
+      {
+          std::call_once(computed, [&] { value = compute(); isReady.store(true, std::memory_order_release); });
+          return value;
+      }
+
+      // The value if it has been computed, without computing it; otherwise nullptr.
+      const T * ifComputed() const
+      {
+          return isReady.load(std::memory_order_acquire) ? &value : nullptr;
+      }
+
+    private:
+      mutable std::once_flag computed;
+      mutable std::atomic<bool> isReady {false};
+      mutable T value {};
+  };
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef NMEAGENERATOR_H_120218
+#define NMEAGENERATOR_H_120218
+
+#include <cstddef>
+
+#include "types.h"
+#include "position.h"
+
+namespace NMEA
+{
+ namespace Generator
+ {
+  /* These functions write a single NMEA sentence, including the checksum and a
+   * terminating newline, into a caller-provided buffer, and return the number of
+   * characters written.  The buffer must have at least maxSentenceLength characters
+   * available.  No memory is allocated.
+   *
+   * Latitudes and longitudes are written in DDM format with 4 decimal places of minutes.
+   * Times are absolute times in seconds (since the Unix epoch); they are written as UTC
+   * hhmmss.sss fields, with RMC sentences also including the ddmmyy date.
+   */
+
+  const std::size_t maxSentenceLength = 96;
+
+  // $GPGLL,lat,N/S,lon,E/W,time,A
+  std::size_t writeGLL(char * buffer, const GPS::Position &, GPS::seconds time);
+
+  // $GPGGA,time,lat,N/S,lon,E/W,1,0,,ele,M,,M,,
+  std::size_t writeGGA(char * buffer, const GPS::Position &, GPS::seconds time);
+
+  // As above, but with an empty time field; used for untimed data such as Routes.
+  std::size_t writeGGA(char * buffer, const GPS::Position &);
+
+  // $GPRMC,time,A,lat,N/S,lon,E/W,0.000,0.00,date,,A
+  std::size_t writeRMC(char * buffer, const GPS::Position &, GPS::seconds time);
+ }
+}
+
+#endif
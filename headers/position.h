@@ -1,6 +1,7 @@
 #ifndef POSITION_H_211217
 #define POSITION_H_211217
 
+#include <cstddef>
 #include <string>
 
 #include "types.h"
@@ -41,6 +42,14 @@ namespace GPS
 
       std::string toString(bool includeElevation = true) const;
 
+      // The maximum number of characters written by formatTo().
+      static const std::size_t maxFormattedLength = 96;
+
+      /* Writes the same text as toString() into a buffer with room for at least maxFormattedLength
+       * characters, without allocating.  Returns a pointer one past the last character written.
+       */
+      char * formatTo(char * buffer, bool includeElevation = true) const;
+
       /* Computes an approximation of the distance between two Positions on the Earth's surface.
        * Does not take into account elevation.
        */
@@ -1,29 +1,69 @@
 #ifndef ROUTE_H_211217
 #define ROUTE_H_211217
 
+#include <memory>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "types.h"
 #include "position.h"
+#include "loadstats.h"
+#include "memo.h"
+#include "sparsetable.h"
 
 namespace GPS
 {
+  // The memory (in bytes) held by a Route or Track, including heap allocations.
+  struct MemoryUsage
+  {
+      std::size_t object = 0; // The Route or Track object itself, and its name.
+      std::size_t positions = 0;
+      std::size_t positionNames = 0; // Including name strings too long to be stored inline.
+      std::size_t times = 0; // Track arrival and departure times.
+      std::size_t report = 0; // The build report, and the stream it is built in.
+      std::size_t caches = 0; // Memoised statistics and prefix sums.
+      std::size_t rangeIndex = 0; // Only if built.
+
+      std::size_t total() const;
+  };
+
   class Route
   {
     public:
       /*  Routes are constructed from GPX data.  The data can be provided as a string, or from a file.
        *  Any route points closer together than a certain minimum distance are discarded.
+       *  GPX data passed as an rvalue string is parsed in place, without being copied; otherwise
+       *  it is copied once.
        */
-      Route(std::string source,
+      Route(std::string && source,
             bool isFileName, // Is the first parameter a file name or a string containing GPX data?
-            metres granularity = 20); // The minimum distance between successive route points.
+            metres granularity = 20, // The minimum distance between successive route points.
+            unsigned int threads = 1); // Parse large GPX data on this many threads (0 for one per core).
+      Route(std::string_view source, bool isFileName, metres granularity = 20, unsigned int threads = 1);
+      Route(const char * source, bool isFileName, metres granularity = 20, unsigned int threads = 1);
+
+      /*  Routes can also be constructed directly from Positions, e.g. generated ones, without any GPX.
+       *  The same minimum distance between successive route points is applied.
+       */
+      Route(const std::vector<Position> & positions,
+            const std::vector<std::string> & positionNames = {}, // Either empty, or one name per Position.
+            const std::string & name = "",
+            metres granularity = 20);
 
       // Returns a report of the construction process; useful for debugging purposes.
       std::string buildReport() const;
 
+      // Timings and counters for the construction process; these are also summarised in the report.
+      const LoadStats & loadStats() const;
+
+      // The memory currently held by this Route.
+      virtual MemoryUsage memoryUsage() const;
+
       /* Update the granularity of the stored Route.  Any position in the Route that differs in distance
        * from its predecessor by less than the updated granularity is discarded.
+       * This is not safe to call while other threads are querying the Route.
        */
       virtual void setGranularity(metres);
 
@@ -33,9 +73,21 @@ namespace GPS
       // Returns the number of stored route points.
       unsigned int numPositions() const;
 
+      /* The statistics that scan every point are computed on first use, and remembered until the points
+       * change.  Any number of threads may query the same Route concurrently.
+       */
+
       // The total length of the Route; this is the sum of the distances between successive route points.
       metres totalLength() const;
 
+      /* The same statistics over the part of the Route from point "from" to point "to" (inclusive),
+       * in constant time, from prefix sums that are computed on first use.
+       * Throws a std::out_of_range exception if "to" is out-of-range, or "from" is after "to".
+       */
+      metres totalLength(unsigned int from, unsigned int to) const;
+      metres totalHeightGain(unsigned int from, unsigned int to) const;
+      metres netHeightGain(unsigned int from, unsigned int to) const;
+
       // The distance between the first and last points on the Route.
       metres netLength() const;
 
@@ -76,6 +128,25 @@ namespace GPS
       // The elevation of the highest point on the Route.
       metres maxElevation() const;
 
+      /* The same extremes over the part of the Route from point "from" to point "to" (inclusive).
+       * These scan the range, unless the range index has been built.
+       * Throws a std::out_of_range exception if "to" is out-of-range, or "from" is after "to".
+       */
+      degrees minLatitude(unsigned int from, unsigned int to) const;
+      degrees maxLatitude(unsigned int from, unsigned int to) const;
+      degrees minLongitude(unsigned int from, unsigned int to) const;
+      degrees maxLongitude(unsigned int from, unsigned int to) const;
+      metres minElevation(unsigned int from, unsigned int to) const;
+      metres maxElevation(unsigned int from, unsigned int to) const;
+
+      /* Builds an index (sparse tables) that answers the range extremes above in constant time.
+       * It takes O(n log n) time and memory, both of which are added to the build report, and
+       * the memory to memoryUsage().rangeIndex.  Once built, it is rebuilt whenever the points change.
+       * Like setGranularity(), this is not safe to call while other threads are querying the Route.
+       */
+      void buildRangeIndex();
+      bool hasRangeIndex() const;
+
       // Return the route point at the specified index.
       // Throws a std::out_of_range exception if out-of-range.
       Position operator[](unsigned int) const;
@@ -95,26 +166,109 @@ namespace GPS
     protected:
       Route() {} // Only called by Track constructor.
 
+      friend class RouteSnapshot;
+
       metres granularity;
       std::ostringstream reportStringStream;
       metres routeLength;
       std::string routeName;
       std::vector<Position> positions;
       std::vector<std::string> positionNames;
-      std::string readFileData(std::string fileName);
-      Position getNewPostion(std::string newPostion);
-      std::string getName(std::string newPostion);
-      void checkElementsExsists(std::string fileData, std::vector<std::string> elements);
-      std::string checkErrors(std::string& gpsData, std::string fileType);
+      std::string readFileData(const std::string & fileName);
+      Position getNewPostion(std::string_view newPostion);
+      std::string getName(std::string_view newPostion);
+      std::string checkErrors(std::string& gpsData, const std::string & fileType);
       void setRouteLength();
-      void addPostion(std::string newPostion);
-      std::string setupFileData(std::vector<std::string> elements,std::string fileData);
+      void finishConstruction();
+
+      // Reduces the GPX data, in place, to the content of the nested "elements", with any track segments merged.
+      void setupFileData(const std::vector<std::string> & elements, std::string & fileData);
       std::string report;
+      LoadStats stats;
+
+      /* Appends the Position, unless it is the same location as the previous one.
+       * Returns whether it was appended.
+       */
+      bool appendPosition(const Position &);
+
+      // A point element of the GPX data, parsed but not yet appended.
+      struct ParsedPoint
+      {
+          Position position;
+          seconds time; // Only used by Tracks.
+          std::string name;
+      };
+
+      // Throws a std::domain_error (or the exception of the Position constructor) if the element is ill-formed.
+      virtual ParsedPoint parsePoint(const std::string & element);
+
+      // The build report line(s) for a Position that has been kept (appended) or ignored.
+      virtual void reportPosition(std::ostream &, const Position &, seconds time, bool kept) const;
+
+      // The effect of appending, or ignoring, a Position on everything but the report.
+      virtual void storePosition(const Position &, seconds time, bool kept);
+
+      void appendParsedPoint(const ParsedPoint &);
+
+      /* Extracts and appends every "elementName" element of the GPX data.
+       * On more than one thread, the data is split into chunks at element boundaries, and the
+       * chunks are parsed and filtered concurrently.  Successive chunks are then joined, re-applying
+       * the granularity filter from each seam only until it agrees with the chunk's own filtering.
+       * The result is identical to parsing on one thread.
+       */
+      void parsePoints(std::string & gpsData, const std::string & elementName, unsigned int threads);
+
+      // Returns false, having appended nothing, if the data cannot be split safely.
+      bool parsePointsInParallel(const std::string & gpsData, const std::string & elementName, unsigned int threads);
 
       /* Two Positions are considered to be the same location is they are less than
        * "granularity" metres apart (horizontally).
        */
       bool areSameLocation(const Position &, const Position &) const;
+
+      // Throws a std::out_of_range exception unless "from" and "to" are the ends of a part of the Route.
+      void checkRange(unsigned int from, unsigned int to) const;
+
+      /* Removes every Position that is not "kept", along with its name.
+       * Tracks also merge the time spent at each removed Position into the preceding kept Position.
+       */
+      virtual void discardPositions(const std::vector<bool> & kept);
+
+      struct StatisticsCache
+      {
+          Memo<metres> totalHeightGain;
+          Memo<degrees> maxGradient;
+          Memo<degrees> minGradient;
+          Memo<degrees> steepestGradient;
+          Memo<degrees> minLatitude;
+          Memo<degrees> maxLatitude;
+          Memo<degrees> minLongitude;
+          Memo<degrees> maxLongitude;
+          Memo<metres> minElevation;
+          Memo<metres> maxElevation;
+
+          // Element i is the sum over the segments before point i.
+          Memo<std::vector<metres>> lengthPrefixSums;
+          Memo<std::vector<metres>> heightGainPrefixSums;
+      };
+
+      // Replaced (never reset) whenever the points change, by invalidateCaches().
+      std::unique_ptr<StatisticsCache> statisticsCache = std::make_unique<StatisticsCache>();
+
+      struct RangeIndex
+      {
+          SparseTable<degrees> minLatitude;
+          SparseTable<degrees,std::greater<degrees>> maxLatitude;
+          SparseTable<degrees> minLongitude;
+          SparseTable<degrees,std::greater<degrees>> maxLongitude;
+          SparseTable<metres> minElevation;
+          SparseTable<metres,std::greater<metres>> maxElevation;
+      };
+
+      std::unique_ptr<const RangeIndex> rangeIndex; // Null unless built.
+
+      // Must be called after any change to the points, once construction is complete.
+      virtual void invalidateCaches();
   };
 }
 
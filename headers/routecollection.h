@@ -0,0 +1,62 @@
+#ifndef ROUTECOLLECTION_H_120218
+#define ROUTECOLLECTION_H_120218
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "route.h"
+#include "track.h"
+
+namespace GPS
+{
+  /* A batch of Routes (or Tracks) loaded from all the GPX files in a directory.
+   *
+   * The files are parsed in parallel, largest first, with each thread taking the next
+   * unparsed file as soon as it finishes one, so that one large file does not hold up a
+   * batch of small ones.  The loaded Routes are nevertheless always in the same (file name)
+   * order, however many threads are used.
+   */
+  template <typename T> // Route or Track
+  class Collection
+  {
+    public:
+      // A file that could not be loaded, and the message of the exception its constructor threw.
+      struct LoadError
+      {
+          std::string fileName;
+          std::string message;
+      };
+
+      /* Load every ".gpx" file in the directory (not its subdirectories), on "threads" threads
+       * (0 for one per core).  A file that cannot be loaded is recorded in errors(), and does
+       * not stop the rest of the batch loading.
+       * Throws a std::invalid_argument exception if the directory cannot be read.
+       */
+      static Collection loadDirectory(const std::string & directory, unsigned int threads = 0);
+
+      // The number of files successfully loaded.
+      std::size_t size() const;
+
+      // Throws a std::out_of_range exception if out-of-range.
+      const T & operator[](std::size_t) const;
+
+      // The file each Route was loaded from (without the directory).
+      const std::string & fileName(std::size_t) const;
+
+      // In file name order.
+      const std::vector<LoadError> & errors() const;
+
+    private:
+      Collection() = default;
+
+      std::vector<std::unique_ptr<T>> items;
+      std::vector<std::string> fileNames;
+      std::vector<LoadError> loadErrors;
+  };
+
+  using RouteCollection = Collection<Route>;
+  using TrackCollection = Collection<Track>;
+}
+
+#endif
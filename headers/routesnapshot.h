@@ -0,0 +1,95 @@
+#ifndef ROUTESNAPSHOT_H_120218
+#define ROUTESNAPSHOT_H_120218
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "types.h"
+#include "position.h"
+#include "route.h"
+
+namespace GPS
+{
+  /* An immutable copy of a Route, with all of its statistics computed up front.
+   *
+   * Snapshots are only ever handled through std::shared_ptr<const RouteSnapshot>, and are never
+   * modified once created, so any number of threads can query the same snapshot concurrently,
+   * without locking.  Updates create a new snapshot, leaving the old one unchanged for any
+   * readers still holding it.
+   */
+  class RouteSnapshot
+  {
+    public:
+      struct Statistics
+      {
+          unsigned int numPositions;
+          metres totalLength;
+          metres netLength;
+          metres totalHeightGain;
+          metres netHeightGain;
+          degrees maxGradient;
+          degrees minGradient;
+          degrees steepestGradient;
+          degrees minLatitude;
+          degrees maxLatitude;
+          degrees minLongitude;
+          degrees maxLongitude;
+          metres minElevation;
+          metres maxElevation;
+      };
+
+      /* A snapshot of the Route's points, names and granularity (but not, for a Track, its times).
+       * Throws a std::domain_error if the Route has no points.
+       */
+      static std::shared_ptr<const RouteSnapshot> of(const Route &);
+
+      const Statistics & statistics() const;
+
+      // For all other queries, e.g. findPosition().
+      const Route & route() const;
+
+      // A new snapshot with the Position appended, unless it is the same location as the last one.
+      std::shared_ptr<const RouteSnapshot> withPosition(const Position &, const std::string & name = "") const;
+
+      // A new snapshot with the points re-filtered at a different granularity.
+      std::shared_ptr<const RouteSnapshot> withGranularity(metres) const;
+
+    private:
+      // Private, so that snapshots are always shared and const.
+      RouteSnapshot(const std::vector<Position> &, const std::vector<std::string> & names,
+                    const std::string & name, metres granularity);
+
+      const Route snapshotRoute;
+      const Statistics stats;
+
+      static std::shared_ptr<const RouteSnapshot> create(const std::vector<Position> &, const std::vector<std::string> & names,
+                                                          const std::string & name, metres granularity);
+  };
+
+  /* The current snapshot of a Route that is being updated while it is read.
+   *
+   * Readers take the current snapshot, and query it for as long as they like; updates build a new
+   * snapshot and publish it atomically (in the style of read-copy-update), so readers never see a
+   * partly updated Route, and are never blocked by an update in progress.  Updates are serialised
+   * with each other.  Each update copies the Route, so this suits Routes that are read far more
+   * often than they are updated.
+   */
+  class SharedRoute
+  {
+    public:
+      // Throws a std::invalid_argument exception if the snapshot is null.
+      explicit SharedRoute(std::shared_ptr<const RouteSnapshot>);
+
+      std::shared_ptr<const RouteSnapshot> snapshot() const;
+
+      void append(const Position &, const std::string & name = "");
+      void setGranularity(metres);
+
+    private:
+      std::shared_ptr<const RouteSnapshot> current; // Only accessed through the std::atomic_... functions.
+      std::mutex updateMutex;
+  };
+}
+
+#endif
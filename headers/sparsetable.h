@@ -0,0 +1,61 @@
+#ifndef SPARSETABLE_H_120218
+#define SPARSETABLE_H_120218
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace GPS
+{
+  /* Answers "the least (according to Compare) value in the range [from,to]" in constant time.
+   *
+   * Level k holds the answer for every range of 2^k values, so building takes O(n log n) time and
+   * memory.  Any range is then covered by two (overlapping) ranges from one level.
+   * E.g. SparseTable<metres> for minima, SparseTable<metres,std::greater<metres>> for maxima.
+   */
+  template <typename T, typename Compare = std::less<T>>
+  class SparseTable
+  {
+    public:
+      explicit SparseTable(std::vector<T> values)
+      {
+          levels.push_back(std::move(values));
+          for (std::size_t width = 2; width <= levels[0].size(); width *= 2)
+          {
+              const std::vector<T> & previous = levels.back();
+              std::vector<T> level(levels[0].size() - width + 1);
+              for (std::size_t i = 0; i < level.size(); ++i)
+              {
+                  level[i] = best(previous[i], previous[i + width / 2]);
+              }
+              levels.push_back(std::move(level));
+          }
+      }
+
+      // Requires from <= to < the number of values.
+      T query(std::size_t from, std::size_t to) const
+      {
+          const int level = std::ilogb(static_cast<double>(to - from + 1));
+          return best(levels[level][from], levels[level][to + 1 - (std::size_t(1) << level)]);
+      }
+
+      // The memory (in bytes) held by the table, excluding the object itself.
+      std::size_t memoryUsage() const
+      {
+          std::size_t bytes = levels.capacity() * sizeof(std::vector<T>);
+          for (const std::vector<T> & level : levels) bytes += level.capacity() * sizeof(T);
+          return bytes;
+      }
+
+    private:
+      std::vector<std::vector<T>> levels;
+
+      static const T & best(const T & a, const T & b)
+      {
+          return Compare()(b, a) ? b : a;
+      }
+  };
+}
+
+#endif
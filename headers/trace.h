@@ -0,0 +1,74 @@
+#ifndef TRACE_H_120218
+#define TRACE_H_120218
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace GPS
+{
+ namespace Trace
+ {
+  /* Scoped trace spans around the phases of loading and analysing Routes and Tracks,
+   * exportable in the Chrome trace_event JSON format (viewable in chrome://tracing or Perfetto).
+   *
+   * Spans are only compiled in when GPS_TRACING is defined (e.g. "DEFINES += GPS_TRACING" in
+   * the .pro file); otherwise a Span is an empty object and costs nothing.  When compiled in,
+   * recording is still off until enable() is called, and a Span then costs one relaxed atomic load.
+   *
+   * Each thread records into its own buffer, without locks; a thread only takes a lock once,
+   * to register its buffer when it records its first span.
+   *
+   * E.g.
+   *     Trace::enable();
+   *     Track track(fileName, true);
+   *     Trace::enable(false);
+   *     std::ofstream file("trace.json");
+   *     Trace::writeJSON(file);
+   */
+
+#ifdef GPS_TRACING
+  static constexpr bool compiledIn = true;
+#else
+  static constexpr bool compiledIn = false;
+#endif
+
+  // Start (or stop) recording spans, on all threads.  Has no effect unless compiledIn.
+  void enable(bool = true);
+  bool enabled();
+
+  // The number of spans recorded (on all threads) since the last clear().
+  std::size_t numEvents();
+
+  /* Discard all recorded spans.
+   * Must not be called while other threads might be recording.
+   */
+  void clear();
+
+  /* Write all recorded spans as a Chrome trace_event JSON object, with one "tid" per thread.
+   * Spans still being recorded by other threads are either written complete, or not at all.
+   */
+  void writeJSON(std::ostream &);
+
+  class Span
+  {
+    public:
+      Span(const Span &) = delete;
+      Span & operator=(const Span &) = delete;
+
+#ifdef GPS_TRACING
+      // The name is not copied, so must outlive the trace (as string literals always do).
+      explicit Span(const char * name);
+      ~Span();
+
+    private:
+      const char * name; // nullptr if recording was off when the Span started.
+      std::int64_t start;
+#else
+      explicit Span(const char *) {}
+#endif
+  };
+ }
+}
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef TRACK_H_211217
 #define TRACK_H_211217
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "types.h"
@@ -15,17 +17,34 @@ namespace GPS
     public:
       /*  Tracks are constructed from GPX data.  The data can be provided as a string, or from a file.
        *  Any track points closer together than a certain minimum distance are discarded.
+       *  As with Routes, GPX data passed as an rvalue string is parsed without being copied.
        */
-      Track(std::string source,
+      Track(std::string && source,
             bool isFileName, // Is the first parameter a file name or a string containing GPX data?
-            metres granularity = 10); // The minimum distance between successive track points.
+            metres granularity = 10, // The minimum distance between successive track points.
+            unsigned int threads = 1); // Parse large GPX data on this many threads (0 for one per core).
+      Track(std::string_view source, bool isFileName, metres granularity = 10, unsigned int threads = 1);
+      Track(const char * source, bool isFileName, metres granularity = 10, unsigned int threads = 1);
+
+      /*  Tracks can also be constructed directly from Positions and the (absolute) times at which they
+       *  were logged, without any GPX.  The same minimum distance between successive track points is applied.
+       */
+      Track(const std::vector<Position> & positions,
+            const std::vector<seconds> & times, // One time per Position.
+            const std::string & name = "",
+            metres granularity = 10);
 
       /* Update the granularity of the stored Track.  Any position in the Track that differs in distance
-       * from its predecessor by less than the updated granularity is discarded.
+       * from its predecessor by less than the updated granularity is discarded, and the time spent
+       * there (and travelling to it) is merged into the time spent at the preceding kept position.
        */
       void setGranularity(metres) override;
 
-      // Total elapsed time between start and finish of track.
+      MemoryUsage memoryUsage() const override;
+
+      /* Total elapsed time between start and finish of track.
+       * This is the last departure time, so is only the elapsed time if the logged times start at 0.
+       */
       seconds totalTime() const;
 
       // Total elapsed time between start and finish of the Track that is spent moving.
@@ -34,6 +53,32 @@ namespace GPS
       // Total elapsed time between start and finish of the Track that is spent not moving.
       seconds restingTime() const;
 
+      /* The same times over the part of the Track from arriving at point "from" to departing from
+       * point "to", in constant time, as with Route::totalLength(from, to).
+       */
+      seconds totalTime(unsigned int from, unsigned int to) const;
+      seconds travellingTime(unsigned int from, unsigned int to) const;
+      seconds restingTime(unsigned int from, unsigned int to) const;
+
+      /* Where the Track was at the given time (on the same scale as the logged times).
+       * While resting, this is the rest Position; between leaving one Position and arriving at the
+       * next, it is interpolated linearly (taking the shorter way around in longitude).
+       * Throws a std::out_of_range exception if the time is before the first arrival or after the last departure.
+       */
+      Position positionAt(seconds) const;
+
+      /* As above, for many times at once, in a single pass through the Track.
+       * Throws a std::invalid_argument exception if the times are not in increasing order.
+       */
+      std::vector<Position> positionsAt(const std::vector<seconds> & times) const;
+
+      /* A Track with a point every "interval" seconds, from the first arrival to the last departure
+       * (inclusive, if the interval divides the time between them), at the positionAt() those times.
+       * Every point is kept, even while resting, i.e. the granularity is zero.
+       * Throws a std::invalid_argument exception if the interval is zero.
+       */
+      Track resampled(seconds interval) const;
+
       // The fastest speed between successive track points.
       // Returns 0 if the entire track is stationary.
       speed maxSpeed() const;
@@ -52,17 +97,45 @@ namespace GPS
       speed maxRateOfDescent() const;
 
     protected:
+      Track() {} // Only called by resampled().
+
       /* These vectors store the arrival time and departure time at each
-       * Position in the Track.  These times are relative to the start of
-       * the Track; thus arrived[0] is always 0.
+       * Position in the Track.  These are the times as logged, not relative to
+       * the start of the Track, so arrived[0] is only 0 if logging started at 0.
        */
       std::vector<seconds> arrived;
       std::vector<seconds> departed;
 
       static seconds stringToTime(const std::string &);
-      seconds getTime(std::string newPostion);
-      void addPostion(std::string newPostion);
+      seconds getTime(std::string_view newPostion);
+
+      /* Appends the Position arriving at the given time, or if it is the same location as the previous
+       * one, extends the time spent there.  Returns whether the Position was appended.
+       */
+      bool appendPosition(const Position &, seconds time);
+
+      ParsedPoint parsePoint(const std::string & element) override;
+      void reportPosition(std::ostream &, const Position &, seconds time, bool kept) const override;
+      void storePosition(const Position &, seconds time, bool kept) override;
+      void discardPositions(const std::vector<bool> & kept) override;
+
+      // Where the Track was at the given time, given that point i is the last one arrived at by then.
+      Position positionAfterArriving(seconds, std::size_t i) const;
+
+      struct TrackStatisticsCache
+      {
+          Memo<seconds> restingTime;
+          Memo<speed> maxSpeed;
+          Memo<speed> maxRateOfAscent;
+          Memo<speed> maxRateOfDescent;
+
+          // Element i is the time spent resting at the points before point i.
+          Memo<std::vector<seconds>> restingTimePrefixSums;
+      };
+
+      std::unique_ptr<TrackStatisticsCache> trackStatisticsCache = std::make_unique<TrackStatisticsCache>();
 
+      void invalidateCaches() override;
   };
 }
 
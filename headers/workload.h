@@ -0,0 +1,70 @@
+#ifndef WORKLOAD_H_120218
+#define WORKLOAD_H_120218
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types.h"
+#include "gridworld_track.h"
+
+namespace GPS
+{
+ namespace Workload
+ {
+  /* Generates reproducible corpora of GPX or NMEA log files for performance testing.
+   *
+   * Each file is a GridWorldTrack following a random walk over a large GridWorld, and is
+   * determined entirely by the Options and its index in the corpus, so the same seed always
+   * produces the same files, however many threads generate them.
+   */
+
+  enum class Format { GPX, NMEA };
+
+  struct Options
+  {
+      std::uint64_t seed = 0;
+      Format format = Format::GPX;
+      std::size_t fileSize = 1 << 20; // Approximate size (in bytes) of each generated file.
+
+      unsigned int gridSize = 201; // Number of rows and columns in the GridWorld.
+      metres horizontalGridUnit = 100;
+      metres verticalGridUnit = 5;
+      metres elevationNoise = 20; // Each grid point's elevation is offset by up to this amount (either way).
+
+      seconds timeUnitDuration = 10;
+      seconds logInterval = 10;
+      unsigned int maxTimeUnitsPerStep = 5;
+
+      double restProbability = 0.05; // Chance of a step staying at the same point (for up to maxRestTimeUnits).
+      unsigned int maxRestTimeUnits = 30;
+      double duplicateProbability = 0.02; // Chance of a step logging the same point again at the same time.
+
+      bool crossAntimeridian = true; // Centre the GridWorld on the antimeridian, rather than at a random position.
+  };
+
+  // The GridWorld for the file with the given index.
+  GridWorld gridWorldFor(const Options &, std::size_t index);
+
+  // The track string for the file with the given index; see GridWorldTrack.
+  std::string trackStringFor(const Options &, std::size_t index);
+
+  GridWorldTrack trackFor(const Options &, std::size_t index);
+
+  // The name of the file with the given index, e.g. "workload-0007.gpx".
+  std::string fileNameFor(const Options &, std::size_t index);
+
+  // Write the file with the given index to an open file descriptor.
+  void writeFile(const Options &, std::size_t index, int fileDescriptor);
+
+  /* Write ceil(totalSize / fileSize) files into an existing directory, in parallel on
+   * "threads" threads (0 for one per core), and return their paths.
+   * Throws a std::runtime_error if a file cannot be written.
+   */
+  std::vector<std::string> generateCorpus(const Options &, const std::string & directory,
+                                          std::size_t totalSize, unsigned int threads = 0);
+ }
+}
+
+#endif
@@ -1,35 +1,100 @@
 #ifndef XMLGENERATOR_H_211217
 #define XMLGENERATOR_H_211217
 
-#include <sstream>
+#include <array>
+#include <cstddef>
+#include <functional>
 #include <string>
-#include <stack>
+#include <string_view>
 
 namespace XML
 {
   class Generator
   {
     public:
-      Generator(unsigned int indentationSpaces = 4);
+      /* A Sink receives the generated XML in chunks, in order.
+       * The Generator collects output in a fixed-size internal buffer, and only passes it to
+       * the Sink when the buffer fills, or when flush() is called.
+       */
+      using Sink = std::function<void(const char * data, std::size_t length)>;
+
+      // Write to an open file descriptor.  Throws a std::runtime_error if writing fails.
+      static Sink fileDescriptorSink(int fileDescriptor);
+
+      // Append to a string, which must outlive the Generator.
+      static Sink stringSink(std::string & destination);
+
+      // Maximum nesting depth of open elements.
+      static const std::size_t maxDepth = 32;
+
+      // Accumulate the XML in memory; retrieve it with closeAllElementsAndExtractString().
+      Generator(unsigned int indentationSpaces = 4,
+                bool compact = false); // Omit all indentation and newlines (for machine-to-machine use).
+
+      // Write the XML through a Sink, in constant memory.
+      Generator(Sink sink,
+                unsigned int indentationSpaces = 4,
+                bool compact = false);
+
+      // Any buffered output is flushed; call flush() explicitly to observe Sink errors.
+      ~Generator();
+
+      Generator(const Generator &) = delete;
+      Generator & operator=(const Generator &) = delete;
 
       void basicXMLDeclaration();
       void openBasicGPXElement();
 
-      void element(const std::string& name, const std::string& attributes, const std::string& content);
-      void openElement(const std::string& name, const std::string& attributes);
+      /* Element names are not copied, so the name passed to openElement() must remain valid
+       * until the element is closed (as string literals always do).
+       * Throws a std::domain_error if more than maxDepth elements are open.
+       */
+      void element(std::string_view name, std::string_view attributes, std::string_view content);
+
+      // Numeric content is formatted as std::to_string() would, but without allocating.
+      void element(std::string_view name, std::string_view attributes, double content);
+      void element(std::string_view name, std::string_view attributes, unsigned long long content);
+      void openElement(std::string_view name, std::string_view attributes);
       void closeElement();
       void closeAllElements();
 
+      // Pass all buffered output to the Sink.
+      void flush();
+
+      /* A Generator (without a Sink) with the same layout as this one, whose output is indented
+       * to be inserted at the current position of this document.  Fragments can be generated
+       * independently (e.g. on other threads), and then inserted in order.
+       */
+      Generator fragment() const;
+
+      // Write XML, such as the string extracted from a fragment, verbatim.
+      void insert(std::string_view xml);
+
+      // Only available when no Sink was provided; throws a std::domain_error otherwise.
       std::string closeAllElementsAndExtractString();
 
     private:
-      std::ostringstream xml;
-      std::stack<std::string> unclosedTags;
+      static const std::size_t bufferSize = 4096;
+
+      Sink sink;
+      char buffer[bufferSize];
+      std::size_t buffered = 0;
+      std::string xml; // Used instead of the buffer when there is no Sink.
+
+      std::array<std::string_view,maxDepth> unclosedTags;
       unsigned int indentationSpaces;
-      unsigned int indentationLevel = 0;
+      unsigned int indentationLevel = 0; // Also the number of unclosed tags.
+      unsigned int baseIndentationLevel = 0; // Non-zero for fragments.
+      bool compact;
+
+      Generator(unsigned int indentationSpaces, bool compact, unsigned int baseIndentationLevel);
+
+      void write(const char * data, std::size_t length);
+      void write(std::string_view str);
+      void write(char c);
 
-      void openingTag(const std::string& name, const std::string& attributes);
-      void closingTag(const std::string& name);
+      void openingTag(std::string_view name, std::string_view attributes);
+      void closingTag(std::string_view name);
 
       void indent();
       void newline();
@@ -2,6 +2,8 @@
 #define XMLPARSER_H_211217
 
 #include <string>
+#include <string_view>
+#include <utility>
 
 namespace XML
 {
@@ -12,40 +14,58 @@ namespace XML
    * it does not handle nested tags of the same name.
    */
 
+  /*  Returns a pair containing <index,length> where index is the index of the start
+   *  of the named element, and length is the length of the element (including its tags),
+   *  or <std::string::npos,0> if there is no such element.
+   */
+  std::pair<std::size_t,std::size_t> findElement(std::string_view source, std::string_view elementName);
+
   /*  Determine whether an element exists in the source string.
    */
-  bool elementExists(const std::string & source, const std::string & elementName);
+  bool elementExists(std::string_view source, std::string_view elementName);
 
 
   /*  Locate and return the named element (including opening/closing tags).
    *  Pre-condition: the element exists somewhere within the source string.
    */
-  std::string getElement(const std::string & source, const std::string & elementName);
+  std::string getElement(std::string_view source, std::string_view elementName);
 
 
   /*  Locate and return the named element (including opening/closing tags).
    *  Then erase that element from teh source string.
    *  Pre-condition: the element exists somewhere within the source string.
    */
-  std::string getAndEraseElement(std::string & source, const std::string & elementName);
+  std::string getAndEraseElement(std::string & source, std::string_view elementName);
 
 
   /*  Return the content (everything between the opening/closing tags)
    *  of an XML element.
    *  Pre-condition: the argument is a valid XML element.
    */
-  std::string getElementContent(const std::string & element);
+  std::string getElementContent(std::string_view element);
+
+  /*  Replace the source string with the content of the named element, in place
+   *  (i.e. equivalent to getElementContent(getElement(...)), but without copying).
+   *  Pre-condition: the element exists somewhere within the source string.
+   */
+  void extractElementContent(std::string & source, std::string_view elementName);
+
+  /*  Remove the named element, and append its content to the end of the source string, in place.
+   *  The first "excludedElementName" element within the content (if any) is discarded.
+   *  Pre-condition: the element exists somewhere within the source string.
+   */
+  void moveElementContentToEnd(std::string & source, std::string_view elementName, std::string_view excludedElementName);
 
   /*  Determine whether an attribute exists in an element.
    *  Pre-condition: the argument is a valid XML element.
    */
-  bool attributeExists(const std::string & element, const std::string & attributeName);
+  bool attributeExists(std::string_view element, std::string_view attributeName);
 
   /*  Return the value of an attribute, or an empty string if the attribute
    *  cannot be found.
    *  Pre-condition: the argument is a valid XML element.
    */
-  std::string getElementAttribute(const std::string & element, const std::string & attributeName);
+  std::string getElementAttribute(std::string_view element, std::string_view attributeName);
 
  }
 }
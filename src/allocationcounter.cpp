@@ -0,0 +1,84 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "allocationcounter.h"
+
+namespace
+{
+    thread_local std::size_t allocationCount = 0;
+
+    // Shared by all threads, as memory is often freed by a different thread from the one that allocated it.
+    std::atomic<std::size_t> bytesInUse {0};
+    std::atomic<std::size_t> peakBytesInUse {0};
+
+    // Each block is preceded by its size, so that operator delete can account for it.
+    const std::size_t headerSize = alignof(std::max_align_t);
+}
+
+void * operator new(std::size_t size)
+{
+    ++allocationCount;
+    void * block = std::malloc(headerSize + size);
+    if (block == nullptr) throw std::bad_alloc();
+    *static_cast<std::size_t *>(block) = size;
+
+    const std::size_t live = bytesInUse.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = peakBytesInUse.load(std::memory_order_relaxed);
+    while (live > peak && ! peakBytesInUse.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+    return static_cast<char *>(block) + headerSize;
+}
+
+// GCC does not recognise that this is the matching replacement for the operator new above.
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void * p) noexcept
+{
+    if (p == nullptr) return;
+    void * block = static_cast<char *>(p) - headerSize;
+    bytesInUse.fetch_sub(*static_cast<std::size_t *>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete(void * p, std::size_t) noexcept
+{
+    ::operator delete(p);
+}
+
+namespace GPS
+{
+  AllocationCounter::AllocationCounter()
+    : startCount{allocationCount},
+      startBytes{bytesInUse.load()}
+  {
+      peakBytesInUse = startBytes;
+  }
+
+  std::size_t AllocationCounter::allocations() const
+  {
+      return allocationCount - startCount;
+  }
+
+  std::size_t AllocationCounter::threadAllocations()
+  {
+      return allocationCount;
+  }
+
+  std::size_t AllocationCounter::peakBytes() const
+  {
+      const std::size_t peak = peakBytesInUse.load();
+      return peak > startBytes ? peak - startBytes : 0;
+  }
+
+  std::size_t AllocationCounter::liveBytes()
+  {
+      return bytesInUse.load();
+  }
+}
@@ -0,0 +1,661 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+#include "logs.h"
+#include "xmlparser.h"
+#include "xmlgenerator.h"
+#include "route.h"
+#include "track.h"
+#include "gridworld_track.h"
+#include "workload.h"
+#include "allocationcounter.h"
+#include "trace.h"
+#include "routecollection.h"
+
+using namespace GPS;
+
+/* Benchmarks GPX generation, and the GPX load and query pipeline.
+ * Run from the "execs" directory, as with the test executables.
+ *
+ * Usage: gpx-bench            Human-readable generation benchmarks.
+ *        gpx-bench pipeline   Per-phase timings of loading and querying Routes and Tracks, as JSON.
+ *        gpx-bench trace [file]   The overhead of recording trace spans, optionally writing the trace to a file.
+ *        gpx-bench collection     Throughput of TrackCollection::loadDirectory on 1, 2, 4, ... threads.
+ *        gpx-bench queries        Latency of the first and of repeated calls to each (memoised) statistic,
+ *                                 of range extremes with and without the range index, and of positionAt and resampled.
+ */
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  // Runs "generate" (which returns the number of bytes produced) and reports the throughput.
+  template <typename Generate>
+  void reportThroughput(const std::string & label, Generate generate)
+  {
+      const unsigned int repetitions = 5;
+      std::size_t bytes = 0;
+      Clock::time_point start = Clock::now();
+      for (unsigned int r = 0; r < repetitions; ++r) bytes += generate();
+      std::chrono::duration<double> elapsed = Clock::now() - start;
+
+      std::cout << label << ": " << (bytes / repetitions) << " bytes, "
+                << (bytes / 1e6) / elapsed.count() << " MB/s" << std::endl;
+  }
+
+  // The previous stream-based implementation of Position::toString(), kept as a baseline.
+  std::string toStringViaStream(const Position & pos)
+  {
+      std::ostringstream oss;
+      oss <<  "lat=\"" << pos.latitude() << "\"";
+      oss << " lon=\"" << pos.longitude() << "\"";
+      oss << " ele=\"" << pos.elevation() << "\"";
+      return oss.str();
+  }
+
+  // Formats 10M points and reports the time per point.
+  void benchmarkPositionFormatting()
+  {
+      const std::size_t numPoints = 10000000;
+      std::vector<Position> positions;
+      const GridWorld gridworld(Earth::CityCampus, 1234.5, 6.7);
+      for (char point = 'A'; point <= 'Y'; ++point) positions.push_back(gridworld[point]);
+
+      auto report = [numPoints] (const std::string & label, Clock::time_point start, std::size_t bytes)
+      {
+          std::chrono::duration<double,std::nano> elapsed = Clock::now() - start;
+          std::cout << label << ": " << elapsed.count() / numPoints << " ns/point ("
+                    << bytes << " bytes)" << std::endl;
+      };
+
+      std::size_t bytes = 0;
+      Clock::time_point start = Clock::now();
+      for (std::size_t i = 0; i < numPoints; ++i) bytes += toStringViaStream(positions[i % positions.size()]).length();
+      report("Position via ostringstream", start, bytes);
+
+      bytes = 0;
+      start = Clock::now();
+      for (std::size_t i = 0; i < numPoints; ++i) bytes += positions[i % positions.size()].toString().length();
+      report("Position::toString        ", start, bytes);
+
+      bytes = 0;
+      start = Clock::now();
+      char buffer[Position::maxFormattedLength];
+      for (std::size_t i = 0; i < numPoints; ++i) bytes += positions[i % positions.size()].formatTo(buffer) - buffer;
+      report("Position::formatTo        ", start, bytes);
+  }
+}
+
+namespace
+{
+  // Compares building a Track by parsing generated GPX with building it directly.
+  void benchmarkTrackConstruction()
+  {
+      const GridWorldTrack track("A100B100C100H", 10, 0, GridWorld(Earth::CliftonCampus, 1000, 5));
+      const seconds logInterval = 1;
+      const unsigned int repetitions = 5;
+
+      auto report = [repetitions] (const std::string & label, Clock::time_point start, unsigned int numPoints)
+      {
+          std::chrono::duration<double,std::nano> elapsed = Clock::now() - start;
+          std::cout << label << ": " << elapsed.count() / (repetitions * numPoints) << " ns/point" << std::endl;
+      };
+
+      const bool isFileName = false;
+      unsigned int numPoints = 0;
+      Clock::time_point start = Clock::now();
+      for (unsigned int r = 0; r < repetitions; ++r) numPoints = Track(track.toGPX(logInterval), isFileName).numPositions();
+      report("Track via GPX             ", start, numPoints);
+
+      const unsigned int oneThreadPerCore = 0;
+      const std::string gpx = track.toGPX(logInterval);
+      start = Clock::now();
+      for (unsigned int r = 0; r < repetitions; ++r) numPoints = Track(gpx, isFileName, 10, oneThreadPerCore).numPositions();
+      report("Track via GPX, in parallel", start, numPoints);
+
+      start = Clock::now();
+      for (unsigned int r = 0; r < repetitions; ++r) numPoints = track.toTrack(logInterval).numPositions();
+      report("GridWorldTrack::toTrack   ", start, numPoints);
+  }
+}
+
+namespace
+{
+  /* Exposes the stages of Route and Track construction, so that each can be timed separately.
+   * The stages are run exactly as the GPX constructors run them.
+   */
+  class Pipeline : public Track
+  {
+    public:
+      Pipeline() : Track(std::vector<Position>(), std::vector<seconds>()) {}
+
+      using Route::readFileData;
+      using Route::setupFileData;
+      using Route::checkErrors;
+      using Route::getNewPostion;
+      using Route::getName;
+      using Track::getTime;
+  };
+
+  struct Measurement
+  {
+      std::string phase;
+      double nanoseconds; // Fastest repetition.
+      std::size_t allocations; // In one repetition.
+  };
+
+  // Times "run", which returns a value that is accumulated to keep it from being optimised away.
+  template <typename Run>
+  Measurement measure(const std::string & phase, unsigned int repetitions, Run run)
+  {
+      static volatile double sink;
+      Measurement m {phase, 0, 0};
+      for (unsigned int r = 0; r < repetitions; ++r)
+      {
+          AllocationCounter counter;
+          Clock::time_point start = Clock::now();
+          sink = sink + static_cast<double>(run());
+          std::chrono::duration<double,std::nano> elapsed = Clock::now() - start;
+          m.allocations = counter.allocations();
+          m.nanoseconds = (r == 0) ? elapsed.count() : std::min(m.nanoseconds, elapsed.count());
+      }
+      return m;
+  }
+
+  struct PipelineInput
+  {
+      std::string name;
+      std::string path;
+      bool isTrack;
+      unsigned int scale;
+  };
+
+  // Writes the GPX file with its route or track points repeated "scale" times.
+  void writeScaledCopy(const std::string & source, const std::string & destination, unsigned int scale)
+  {
+      std::ifstream in(source);
+      std::ostringstream contents;
+      contents << in.rdbuf();
+      const std::string gpx = contents.str();
+
+      const std::size_t pointsBegin = gpx.find("<rtept");
+      const std::size_t pointsEnd = gpx.rfind("</rtept>") + std::string("</rtept>").length();
+      std::ofstream out(destination);
+      out << gpx.substr(0, pointsBegin);
+      for (unsigned int i = 0; i < scale; ++i) out << gpx.substr(pointsBegin, pointsEnd - pointsBegin);
+      out << gpx.substr(pointsEnd);
+  }
+
+  void writeJSONMeasurements(std::ostream & json, const std::vector<Measurement> & measurements,
+                             std::size_t bytes, std::size_t points)
+  {
+      json << "      \"phases\": [\n";
+      for (std::size_t i = 0; i < measurements.size(); ++i)
+      {
+          const Measurement & m = measurements[i];
+          json << "        {\"phase\": \"" << m.phase << "\""
+               << ", \"ns\": " << m.nanoseconds
+               << ", \"ns_per_point\": " << m.nanoseconds / points
+               << ", \"allocations_per_point\": " << static_cast<double>(m.allocations) / points
+               << ", \"mb_per_s\": " << (bytes / 1e6) / (m.nanoseconds / 1e9)
+               << "}" << (i + 1 < measurements.size() ? "," : "") << "\n";
+      }
+      json << "      ]\n";
+  }
+
+  std::vector<Measurement> measurePipeline(const PipelineInput & input, unsigned int repetitions,
+                                           std::size_t & bytes, std::size_t & points)
+  {
+      const metres granularity = input.isTrack ? 10 : 20;
+      const std::string pointElement = input.isTrack ? "trkpt" : "rtept";
+      Pipeline pipeline;
+      std::vector<Measurement> measurements;
+
+      std::string fileData;
+      measurements.push_back(measure("read", repetitions, [&] ()
+      {
+          fileData = pipeline.readFileData(input.path);
+          return fileData.length();
+      }));
+      bytes = fileData.length();
+
+      std::vector<std::string> elements;
+      std::string name;
+      measurements.push_back(measure("tokenise", repetitions, [&] ()
+      {
+          std::string gpsData = fileData; // The constructors parse in place, without this copy.
+          pipeline.setupFileData({"gpx", input.isTrack ? "trk" : "rte"}, gpsData);
+          name.clear();
+          if (XML::Parser::elementExists(gpsData, "name"))
+              name = XML::Parser::getElementContent(XML::Parser::getAndEraseElement(gpsData, "name"));
+          elements.clear();
+          while (XML::Parser::elementExists(gpsData, pointElement)) elements.push_back(pipeline.checkErrors(gpsData, pointElement));
+          return elements.size();
+      }));
+      points = elements.size();
+
+      std::vector<Position> positions;
+      std::vector<std::string> names;
+      std::vector<seconds> times;
+      measurements.push_back(measure("positions", repetitions, [&] ()
+      {
+          positions.clear();
+          names.clear();
+          times.clear();
+          for (const std::string & element : elements)
+          {
+              positions.push_back(pipeline.getNewPostion(element));
+              if (input.isTrack) times.push_back(pipeline.getTime(element));
+              else names.push_back(pipeline.getName(element));
+          }
+          return positions.size();
+      }));
+
+      /* Statistics are cheap, so each is repeated enough times to be measurable, and reported per call.
+       * The scanning statistics are memoised, so this is mostly the cost of a cached lookup;
+       * "gpx-bench queries" measures the first call separately.
+       */
+      const unsigned int statisticCalls = 100;
+      auto measureStatistic = [&] (const std::string & statistic, std::function<double()> compute)
+      {
+          Measurement m = measure("stat:" + statistic, repetitions, [&] ()
+          {
+              double total = 0;
+              for (unsigned int i = 0; i < statisticCalls; ++i) total += compute();
+              return total;
+          });
+          m.nanoseconds /= statisticCalls;
+          m.allocations /= statisticCalls;
+          measurements.push_back(m);
+      };
+
+      if (input.isTrack)
+      {
+          std::unique_ptr<Track> track;
+          measurements.push_back(measure("filter", repetitions, [&] ()
+          {
+              track = std::make_unique<Track>(positions, times, name, granularity);
+              return track->numPositions();
+          }));
+          measurements.push_back(measure("construct", repetitions, [&] ()
+          {
+              const bool isFileName = true;
+              return Track(input.path, isFileName, granularity).numPositions();
+          }));
+          measureStatistic("totalTime", [&] { return track->totalTime(); });
+          measureStatistic("restingTime", [&] { return track->restingTime(); });
+          measureStatistic("travellingTime", [&] { return track->travellingTime(); });
+          measureStatistic("maxSpeed", [&] { return track->maxSpeed(); });
+          measureStatistic("averageSpeed", [&] { return track->averageSpeed(true); });
+          measureStatistic("maxRateOfAscent", [&] { return track->maxRateOfAscent(); });
+          measureStatistic("maxRateOfDescent", [&] { return track->maxRateOfDescent(); });
+      }
+      std::unique_ptr<Route> route;
+      measurements.push_back(measure(input.isTrack ? "filter:route" : "filter", repetitions, [&] ()
+      {
+          route = std::make_unique<Route>(positions, names, name, granularity);
+          return route->numPositions();
+      }));
+      if (! input.isTrack)
+      {
+          measurements.push_back(measure("construct", repetitions, [&] ()
+          {
+              const bool isFileName = true;
+              return Route(input.path, isFileName, granularity).numPositions();
+          }));
+      }
+      const Position & somewhere = positions[positions.size() / 2];
+      measureStatistic("totalLength", [&] { return route->totalLength(); });
+      measureStatistic("netLength", [&] { return route->netLength(); });
+      measureStatistic("totalHeightGain", [&] { return route->totalHeightGain(); });
+      measureStatistic("netHeightGain", [&] { return route->netHeightGain(); });
+      measureStatistic("maxGradient", [&] { return route->maxGradient(); });
+      measureStatistic("minGradient", [&] { return route->minGradient(); });
+      measureStatistic("steepestGradient", [&] { return route->steepestGradient(); });
+      measureStatistic("minLatitude", [&] { return route->minLatitude(); });
+      measureStatistic("maxLatitude", [&] { return route->maxLatitude(); });
+      measureStatistic("minLongitude", [&] { return route->minLongitude(); });
+      measureStatistic("maxLongitude", [&] { return route->maxLongitude(); });
+      measureStatistic("minElevation", [&] { return route->minElevation(); });
+      measureStatistic("maxElevation", [&] { return route->maxElevation(); });
+      measureStatistic("timesVisited", [&] { return route->timesVisited(somewhere); });
+      return measurements;
+  }
+
+  /* Runs the pipeline on the bundled GPX routes and on synthetic scaled copies of them,
+   * and on synthetic tracks, and writes the measurements as JSON.
+   */
+  void benchmarkPipeline(std::ostream & json)
+  {
+      const unsigned int repetitions = 5;
+      const std::vector<std::string> routeFiles = {"NottinghamToLondon", "Nottingham-Stoke", "NorthYorkMoors"};
+      const std::vector<unsigned int> scales = {1, 2, 4};
+
+      char directory[] = "/tmp/gpx-benchXXXXXX";
+      if (::mkdtemp(directory) == nullptr) throw std::runtime_error("Cannot create a temporary directory.");
+
+      std::vector<PipelineInput> inputs;
+      for (const std::string & routeFile : routeFiles)
+      {
+          const std::string source = LogFiles::GPXRoutesDir + routeFile + ".gpx";
+          for (unsigned int scale : scales)
+          {
+              std::string path = source;
+              if (scale > 1)
+              {
+                  path = std::string(directory) + "/" + routeFile + "-x" + std::to_string(scale) + ".gpx";
+                  writeScaledCopy(source, path, scale);
+              }
+              inputs.push_back({routeFile + ".gpx", path, false, scale});
+          }
+      }
+
+      Workload::Options options;
+      options.seed = 2018;
+      options.gridSize = 101;
+      for (unsigned int scale : scales)
+      {
+          options.fileSize = scale * 150000;
+          const std::string path = std::string(directory) + "/" + Workload::fileNameFor(options, scale);
+          std::FILE * file = std::fopen(path.c_str(), "w");
+          if (file == nullptr) throw std::runtime_error("Cannot write '" + path + "'.");
+          Workload::writeFile(options, 0, fileno(file));
+          std::fclose(file);
+          inputs.push_back({"workload-track.gpx", path, true, scale});
+      }
+
+      json << "{\n  \"benchmark\": \"gpx-pipeline\",\n  \"repetitions\": " << repetitions << ",\n  \"inputs\": [\n";
+      for (std::size_t i = 0; i < inputs.size(); ++i)
+      {
+          std::size_t bytes = 0;
+          std::size_t points = 0;
+          const std::vector<Measurement> measurements = measurePipeline(inputs[i], repetitions, bytes, points);
+
+          json << "    {\n      \"name\": \"" << inputs[i].name << "\",\n"
+               << "      \"type\": \"" << (inputs[i].isTrack ? "track" : "route") << "\",\n"
+               << "      \"scale\": " << inputs[i].scale << ",\n"
+               << "      \"bytes\": " << bytes << ",\n"
+               << "      \"points\": " << points << ",\n";
+          writeJSONMeasurements(json, measurements, bytes, points);
+          json << "    }" << (i + 1 < inputs.size() ? "," : "") << "\n";
+
+          if (inputs[i].path.compare(0, std::string(directory).length(), directory) == 0) std::remove(inputs[i].path.c_str());
+      }
+      json << "  ]\n}" << std::endl;
+
+      ::rmdir(directory);
+  }
+}
+
+namespace
+{
+  /* Compares loading and querying a Track with trace spans recorded and not recorded.
+   * (With GPS_TRACING undefined, both cases are untraced.)
+   */
+  void benchmarkTracingOverhead(const std::string & traceFileName)
+  {
+      const unsigned int repetitions = 10;
+
+      Workload::Options options;
+      options.seed = 2018;
+      options.gridSize = 101;
+      options.fileSize = 600000;
+      std::string gpx;
+      Workload::trackFor(options, 0).toGPX(XML::Generator::stringSink(gpx), options.logInterval);
+
+      auto loadAndQuery = [&gpx] ()
+      {
+          const bool isFileName = false;
+          const Track track(gpx, isFileName);
+          return track.totalHeightGain() + track.maxGradient() + track.minGradient() + track.steepestGradient()
+               + track.minLatitude() + track.maxLatitude() + track.minLongitude() + track.maxLongitude()
+               + track.minElevation() + track.maxElevation() + track.maxSpeed() + track.averageSpeed(false)
+               + track.maxRateOfAscent() + track.maxRateOfDescent();
+      };
+
+      // Alternate the two cases, so that they are equally affected by any drift in machine load.
+      double untraced = 0;
+      double traced = 0;
+      for (unsigned int r = 0; r < repetitions; ++r)
+      {
+          for (bool tracing : {false, true})
+          {
+              Trace::enable(tracing);
+              const double nanoseconds = measure("", 1, loadAndQuery).nanoseconds;
+              double & fastest = tracing ? traced : untraced;
+              fastest = (r == 0) ? nanoseconds : std::min(fastest, nanoseconds);
+          }
+      }
+      Trace::enable(false);
+
+      std::cout << "Tracing " << (Trace::compiledIn ? "compiled in" : "compiled out") << ", "
+                << gpx.length() << " bytes of GPX" << std::endl;
+      std::cout << "Load and query, not recording: " << untraced / 1e6 << " ms" << std::endl;
+      std::cout << "Load and query, recording    : " << traced / 1e6 << " ms ("
+                << Trace::numEvents() << " spans recorded)" << std::endl;
+      std::cout << "Overhead: " << 100 * (traced - untraced) / untraced << "%" << std::endl;
+
+      if (! traceFileName.empty())
+      {
+          std::ofstream file(traceFileName);
+          Trace::writeJSON(file);
+          if (! file) throw std::runtime_error("Cannot write '" + traceFileName + "'.");
+          std::cout << "Trace written to '" << traceFileName << "'." << std::endl;
+      }
+  }
+}
+
+namespace
+{
+  // Loads a directory of workload tracks of varied sizes, on increasing numbers of threads.
+  void benchmarkCollectionLoading()
+  {
+      const std::size_t numFiles = 64;
+
+      char directory[] = "/tmp/gpx-benchXXXXXX";
+      if (::mkdtemp(directory) == nullptr) throw std::runtime_error("Cannot create a temporary directory.");
+
+      Workload::Options options;
+      options.seed = 2018;
+      options.gridSize = 101;
+      std::size_t totalBytes = 0;
+      std::vector<std::string> paths;
+      for (std::size_t index = 0; index < numFiles; ++index)
+      {
+          options.fileSize = 20000 * (1 + index % 8);
+          paths.push_back(std::string(directory) + "/" + Workload::fileNameFor(options, index));
+          std::FILE * file = std::fopen(paths.back().c_str(), "w");
+          if (file == nullptr) throw std::runtime_error("Cannot write '" + paths.back() + "'.");
+          Workload::writeFile(options, index, fileno(file));
+          totalBytes += static_cast<std::size_t>(std::ftell(file));
+          std::fclose(file);
+      }
+
+      const unsigned int cores = std::max(std::thread::hardware_concurrency(), 1U);
+      double oneThread = 0;
+      for (unsigned int threads = 1; threads <= std::max(cores, 2U); threads *= 2)
+      {
+          Clock::time_point start = Clock::now();
+          const TrackCollection tracks = TrackCollection::loadDirectory(directory, threads);
+          std::chrono::duration<double> elapsed = Clock::now() - start;
+          if (threads == 1) oneThread = elapsed.count();
+
+          std::cout << "TrackCollection::loadDirectory, " << threads << " thread(s): "
+                    << totalBytes / elapsed.count() / 1e6 << " MB/s, speed-up " << oneThread / elapsed.count()
+                    << " (" << tracks.size() << " tracks, " << tracks.errors().size() << " errors)" << std::endl;
+      }
+
+      for (const std::string & path : paths) std::remove(path.c_str());
+      ::rmdir(directory);
+  }
+}
+
+namespace
+{
+  /* Times the first call to each statistic (which scans every point), on a newly loaded Track,
+   * and the average of many repeated calls (which return the memoised value).
+   */
+  void benchmarkRepeatedQueries()
+  {
+      const unsigned int repetitions = 5;
+      const unsigned int repeatedCalls = 1000000;
+
+      Workload::Options options;
+      options.seed = 2018;
+      options.gridSize = 101;
+      options.fileSize = 2000000;
+      std::string gpx;
+      Workload::trackFor(options, 0).toGPX(XML::Generator::stringSink(gpx), options.logInterval);
+
+      const std::vector<std::pair<std::string, std::function<double(const Track &)>>> statistics =
+      {
+          {"totalHeightGain",  [] (const Track & t) { return t.totalHeightGain(); }},
+          {"maxGradient",      [] (const Track & t) { return t.maxGradient(); }},
+          {"minGradient",      [] (const Track & t) { return t.minGradient(); }},
+          {"steepestGradient", [] (const Track & t) { return t.steepestGradient(); }},
+          {"minLatitude",      [] (const Track & t) { return t.minLatitude(); }},
+          {"maxLatitude",      [] (const Track & t) { return t.maxLatitude(); }},
+          {"minLongitude",     [] (const Track & t) { return t.minLongitude(); }},
+          {"maxLongitude",     [] (const Track & t) { return t.maxLongitude(); }},
+          {"minElevation",     [] (const Track & t) { return t.minElevation(); }},
+          {"maxElevation",     [] (const Track & t) { return t.maxElevation(); }},
+          {"restingTime",      [] (const Track & t) { return t.restingTime(); }},
+          {"maxSpeed",         [] (const Track & t) { return t.maxSpeed(); }},
+          {"maxRateOfAscent",  [] (const Track & t) { return t.maxRateOfAscent(); }},
+          {"maxRateOfDescent", [] (const Track & t) { return t.maxRateOfDescent(); }},
+      };
+
+      const bool isFileName = false;
+      const Track track(gpx, isFileName);
+      std::cout << track.numPositions() << " track points" << std::endl;
+
+      for (const auto & statistic : statistics)
+      {
+          double first = 0;
+          for (unsigned int r = 0; r < repetitions; ++r)
+          {
+              Track fresh(gpx, isFileName);
+              const double nanoseconds = measure("", 1, [&] { return statistic.second(fresh); }).nanoseconds;
+              first = (r == 0) ? nanoseconds : std::min(first, nanoseconds);
+          }
+
+          statistic.second(track);
+          const double repeated = measure("", repetitions, [&] ()
+          {
+              double total = 0;
+              for (unsigned int i = 0; i < repeatedCalls; ++i) total += statistic.second(track);
+              return total;
+          }).nanoseconds / repeatedCalls;
+
+          std::cout << statistic.first << ": first call " << first / 1e3 << " us, repeated calls "
+                    << repeated << " ns" << std::endl;
+      }
+
+      // Windows of every length, as when dragging a selection across the whole Track.
+      const unsigned int numWindows = 10000;
+      auto rangeQueries = [&] (const Track & t)
+      {
+          double total = 0;
+          const unsigned int n = t.numPositions();
+          for (unsigned int w = 0; w < numWindows; ++w)
+          {
+              const unsigned int from = (w * 7919U) % n;
+              const unsigned int to = from + (w % (n - from));
+              total += t.minElevation(from, to) + t.maxElevation(from, to);
+          }
+          return total;
+      };
+      Track indexed(gpx, isFileName);
+      const double scanned = measure("", repetitions, [&] { return rangeQueries(indexed); }).nanoseconds / numWindows;
+      const Measurement build = measure("", 1, [&] { indexed.buildRangeIndex(); return 0; });
+      const double looked = measure("", repetitions, [&] { return rangeQueries(indexed); }).nanoseconds / numWindows;
+      std::cout << "Range index: built in " << build.nanoseconds / 1e3 << " us, "
+                << indexed.memoryUsage().rangeIndex << " bytes" << std::endl;
+      std::cout << "min/maxElevation(from,to): scanned " << scanned << " ns, indexed " << looked << " ns" << std::endl;
+
+      // One lookup per second of a Track logged every 10 seconds (from time 0), singly and as a batch.
+      const Track logged = GridWorldTrack("A500B500C500H500M500N500S500X500Y", 10, 0,
+                                          GridWorld(Earth::CliftonCampus, 1000, 5)).toTrack(10);
+      std::vector<seconds> times;
+      for (seconds t = 0; t <= logged.totalTime(); ++t) times.push_back(t);
+      const double single = measure("", repetitions, [&] ()
+      {
+          double total = 0;
+          for (seconds t : times) total += logged.positionAt(t).latitude();
+          return total;
+      }).nanoseconds / times.size();
+      const double batch = measure("", repetitions, [&] { return logged.positionsAt(times).back().latitude(); }).nanoseconds / times.size();
+      std::cout << "positionAt: " << single << " ns per time, positionsAt: " << batch << " ns per time" << std::endl;
+
+      const Measurement resampling = measure("", repetitions, [&] { return logged.resampled(1).numPositions(); });
+      std::cout << "resampled(1): " << resampling.nanoseconds / times.size() << " ns per point, "
+                << resampling.allocations << " allocations" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "pipeline")
+    {
+        benchmarkPipeline(std::cout);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "collection")
+    {
+        benchmarkCollectionLoading();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "queries")
+    {
+        benchmarkRepeatedQueries();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "trace")
+    {
+        benchmarkTracingOverhead(argc > 2 ? argv[2] : "");
+        return 0;
+    }
+
+    // A long track logged every second: 8 segments of 5000 seconds each.
+    const GridWorldTrack track("A500B500C500H500M500N500S500X500Y", 10, 0, GridWorld(Earth::CliftonCampus, 1000, 5));
+    const seconds logInterval = 1;
+
+    for (bool compact : {false, true})
+    {
+        const std::string layout = compact ? " (compact)" : " (indented)";
+
+        reportThroughput("GridWorldTrack::toGPX string  " + layout, [&] ()
+        {
+            return track.toGPX(logInterval, true, "", compact).length();
+        });
+
+        reportThroughput("GridWorldTrack::toGPX sink    " + layout, [&] ()
+        {
+            std::size_t bytes = 0;
+            track.toGPX([&bytes] (const char *, std::size_t length) { bytes += length; },
+                        logInterval, true, "", compact);
+            return bytes;
+        });
+
+        reportThroughput("GridWorldTrack::toGPX parallel" + layout, [&] ()
+        {
+            const unsigned int oneThreadPerCore = 0;
+            return track.toGPX(logInterval, true, "", compact, oneThreadPerCore).length();
+        });
+    }
+
+    benchmarkPositionFormatting();
+    benchmarkTrackConstruction();
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "route.h"
+#include "track.h"
+
+using namespace GPS;
+
+/* Reports the memory held by the Route or Track loaded from each file in the GPX logs,
+ * broken down as in Route::memoryUsage(), and in bytes per point.
+ * Run from the "execs" directory, as with the test executables.
+ * Files that cannot be loaded (some logs are deliberately invalid) are skipped.
+ */
+
+namespace
+{
+  void reportDirectory(const std::string & directory, bool tracks)
+  {
+      std::vector<std::string> paths;
+      for (const std::filesystem::directory_entry & entry : std::filesystem::directory_iterator(directory))
+      {
+          if (entry.path().extension() == ".gpx") paths.push_back(entry.path().string());
+      }
+      std::sort(paths.begin(), paths.end());
+
+      const bool isFileName = true;
+      for (const std::string & path : paths)
+      {
+          MemoryUsage usage;
+          unsigned int points;
+          try
+          {
+              if (tracks)
+              {
+                  const Track track(path, isFileName);
+                  usage = track.memoryUsage();
+                  points = track.numPositions();
+              }
+              else
+              {
+                  const Route route(path, isFileName);
+                  usage = route.memoryUsage();
+                  points = route.numPositions();
+              }
+          }
+          catch (const std::exception &)
+          {
+              continue;
+          }
+
+          std::cout << std::left << std::setw(48) << std::filesystem::path(path).filename().string() << std::right
+                    << std::setw(8) << points
+                    << std::setw(10) << usage.total()
+                    << std::setw(10) << std::fixed << std::setprecision(1) << static_cast<double>(usage.total()) / std::max(points, 1U)
+                    << std::setw(10) << usage.positions
+                    << std::setw(10) << usage.positionNames
+                    << std::setw(10) << usage.times
+                    << std::setw(10) << usage.report
+                    << std::setw(10) << usage.object + usage.caches + usage.rangeIndex << std::endl;
+      }
+  }
+}
+
+int main()
+{
+    std::cout << std::left << std::setw(48) << "File" << std::right
+              << std::setw(8) << "Points" << std::setw(10) << "Bytes" << std::setw(10) << "B/point"
+              << std::setw(10) << "Positions" << std::setw(10) << "Names" << std::setw(10) << "Times"
+              << std::setw(10) << "Report" << std::setw(10) << "Other" << std::endl;
+
+    const bool tracks = true;
+    reportDirectory(LogFiles::GPXRoutesDir, ! tracks);
+    reportDirectory(LogFiles::GPXTracksDir, tracks);
+}
@@ -0,0 +1,126 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+#include "types.h"
+#include "earth.h"
+#include "gridworld.h"
+#include "gridworld_route.h"
+#include "gridworld_track.h"
+
+using namespace GPS;
+
+/* GridWorld stores its Points in a flat array.  These tests check the lookup bounds,
+ * that a GridWorld built from angular grid units matches one built from distances, and
+ * that grids other than 5x5 can be addressed by (row,column) Coordinates.
+ */
+
+BOOST_AUTO_TEST_SUITE( GridWorld_points )
+
+BOOST_AUTO_TEST_CASE( centralPointIsReference )
+{
+   const double percentageAccuracy = 1e-10;
+   GridWorld gridworld(Earth::CityCampus, 1000, 10);
+   BOOST_CHECK_CLOSE( gridworld['M'].latitude(), Earth::CityCampus.latitude(), percentageAccuracy );
+   BOOST_CHECK_CLOSE( gridworld['M'].longitude(), Earth::CityCampus.longitude(), percentageAccuracy );
+   BOOST_CHECK_EQUAL( gridworld['M'].elevation(), Earth::CityCampus.elevation() );
+}
+
+BOOST_AUTO_TEST_CASE( pointsOutsideGridThrow )
+{
+   GridWorld gridworld;
+   BOOST_CHECK_NO_THROW( gridworld['A'] );
+   BOOST_CHECK_NO_THROW( gridworld['Y'] );
+   BOOST_CHECK_THROW( gridworld['Z'], std::out_of_range );
+   BOOST_CHECK_THROW( gridworld['@'], std::out_of_range );
+   BOOST_CHECK_THROW( gridworld['a'], std::out_of_range );
+   BOOST_CHECK_THROW( gridworld['\0'], std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( angularUnitsMatchDistances )
+{
+   const metres horizontalGridUnit = 5000;
+   const metres verticalGridUnit = 20;
+   GridWorld fromDistances(Earth::CliftonCampus, horizontalGridUnit, verticalGridUnit);
+   GridWorld fromAngles = GridWorld::fromAngularUnits(Earth::CliftonCampus,
+                                                      Earth::latitudeSubtendedBy(horizontalGridUnit),
+                                                      Earth::longitudeSubtendedBy(horizontalGridUnit, Earth::CliftonCampus.latitude()),
+                                                      verticalGridUnit);
+
+   for (GridWorld::Point point = 'A'; point <= 'Y'; ++point)
+   {
+       BOOST_CHECK_EQUAL( fromAngles[point].latitude(), fromDistances[point].latitude() );
+       BOOST_CHECK_EQUAL( fromAngles[point].longitude(), fromDistances[point].longitude() );
+       BOOST_CHECK_EQUAL( fromAngles[point].elevation(), fromDistances[point].elevation() );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( standardGridCoordinatesMatchPoints )
+{
+   GridWorld gridworld(Earth::CityCampus, 1000, 10);
+   GridWorld explicitSize(GridWorld::gridSize, GridWorld::gridSize, Earth::CityCampus, 1000, 10);
+   for (GridWorld::Point point = 'A'; point <= 'Y'; ++point)
+   {
+       const GridWorld::Coordinates coords = GridWorld::coordinatesOf(point);
+       BOOST_CHECK_EQUAL( gridworld.nameOf(coords), std::string(1,point) );
+       BOOST_CHECK_EQUAL( gridworld[coords].latitude(), gridworld[point].latitude() );
+       BOOST_CHECK_EQUAL( explicitSize[coords].longitude(), gridworld[point].longitude() );
+       BOOST_CHECK_EQUAL( explicitSize[point].elevation(), gridworld[point].elevation() );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( largeGrid )
+{
+   const double percentageAccuracy = 1e-10;
+   const unsigned int rows = 101;
+   const unsigned int columns = 300;
+   GridWorld gridworld(rows, columns, Earth::CityCampus, 10, 1);
+
+   BOOST_CHECK_EQUAL( gridworld.rows(), rows );
+   BOOST_CHECK_EQUAL( gridworld.columns(), columns );
+   const Position & centre = gridworld[GridWorld::Coordinates{50,150}];
+   BOOST_CHECK_CLOSE( centre.latitude(), Earth::CityCampus.latitude(), percentageAccuracy );
+   BOOST_CHECK_CLOSE( centre.longitude(), Earth::CityCampus.longitude(), percentageAccuracy );
+   BOOST_CHECK_EQUAL( gridworld.nameOf(GridWorld::Coordinates{100,299}), "(100,299)" );
+   char name[GridWorld::maxNameLength];
+   BOOST_CHECK_EQUAL( std::string(name, gridworld.formatName(name, GridWorld::Coordinates{100,299})), "(100,299)" );
+   BOOST_CHECK_EQUAL( std::string(name, gridworld.formatName(name, GridWorld::Coordinates{4294967295U,4294967295U})),
+                      "(4294967295,4294967295)" );
+
+   BOOST_CHECK_NO_THROW( (gridworld[GridWorld::Coordinates{100,299}]) );
+   BOOST_CHECK_THROW( (gridworld[GridWorld::Coordinates{101,0}]), std::out_of_range );
+   BOOST_CHECK_THROW( (gridworld[GridWorld::Coordinates{0,300}]), std::out_of_range );
+   BOOST_CHECK_THROW( gridworld['A'], std::out_of_range );
+   BOOST_CHECK_THROW( GridWorld(0, columns), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( coordinatesInRouteAndTrackStrings )
+{
+   GridWorld gridworld(20, 20);
+   BOOST_CHECK( GridWorldRoute::isValidRouteString("(0,0)(19,19)(7,3)") );
+   BOOST_CHECK( GridWorldRoute::isValidRouteString("A(2,2)Y") );
+   BOOST_CHECK( ! GridWorldRoute::isValidRouteString("(0,0") );
+   BOOST_CHECK( ! GridWorldRoute::isValidRouteString("(,0)") );
+   BOOST_CHECK( ! GridWorldRoute::isValidRouteString("(0 0)") );
+
+   BOOST_CHECK_NO_THROW( GridWorldRoute("(0,0)(19,19)(7,3)", gridworld) );
+   BOOST_CHECK_THROW( GridWorldRoute("(0,0)(20,19)", gridworld), std::invalid_argument );
+
+   BOOST_CHECK( GridWorldTrack::isValidTrackString("(0,0)3(19,19)1(7,3)") );
+   BOOST_CHECK( ! GridWorldTrack::isValidTrackString("(0,0)3(19,19)1") );
+   BOOST_CHECK_NO_THROW( GridWorldTrack("(0,0)3(19,19)1(7,3)", 10, 0, gridworld) );
+   BOOST_CHECK_THROW( GridWorldTrack("(0,0)3(0,20)", 10, 0, gridworld), std::invalid_argument );
+
+   // A-Y only name points of the 5x5 grid, as with GridWorld::operator[](Point).
+   BOOST_CHECK_THROW( GridWorldRoute("ABC", gridworld), std::invalid_argument );
+   BOOST_CHECK_THROW( GridWorldRoute("(0,0)B", gridworld), std::invalid_argument );
+   BOOST_CHECK_THROW( GridWorldTrack("A1(0,1)", 10, 0, gridworld), std::invalid_argument );
+   BOOST_CHECK_NO_THROW( GridWorldRoute("A(2,2)Y") );
+
+   const std::string gpx = GridWorldRoute("(0,0)(19,19)", gridworld).toGPX();
+   BOOST_CHECK( gpx.find("<name>(19,19)</name>") != std::string::npos );
+   const std::string trackGPX = GridWorldTrack("(0,0)1(19,19)", 10, 0, gridworld).toGPX(10);
+   BOOST_CHECK( trackGPX.find("<name>(0,0)-(19,19)</name>") != std::string::npos );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
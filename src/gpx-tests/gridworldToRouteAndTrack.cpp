@@ -0,0 +1,78 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+#include "types.h"
+#include "route.h"
+#include "track.h"
+#include "gridworld_route.h"
+#include "gridworld_track.h"
+
+using namespace GPS;
+
+/* GridWorldRoute::toRoute() and GridWorldTrack::toTrack() build Routes and Tracks directly,
+ * rather than via GPX.  They should agree with parsing the GPX, apart from the rounding of
+ * the GPX text.
+ */
+
+BOOST_AUTO_TEST_SUITE( GridWorld_toRouteAndTrack )
+
+// GPX latitudes and longitudes have 6 significant figures, so are only accurate to about 10m.
+const double percentageAccuracy = 0.1;
+const double speedPercentageAccuracy = 5;
+const bool isFileName = false;
+
+BOOST_AUTO_TEST_CASE( routeMatchesParsedGPX )
+{
+   const GridWorldRoute gwRoute("ABBCHMMMSY", GridWorld(Earth::CliftonCampus, 1000, 10));
+   const Route parsed(gwRoute.toGPX(), isFileName);
+   const Route direct = gwRoute.toRoute();
+
+   BOOST_CHECK_EQUAL( direct.name(), parsed.name() );
+   BOOST_CHECK_EQUAL( direct.numPositions(), parsed.numPositions() );
+   BOOST_CHECK_EQUAL( direct.numPositions(), 7 );
+   for (unsigned int i = 0; i < direct.numPositions(); ++i)
+   {
+       BOOST_CHECK_EQUAL( direct.findNameOf(direct[i]), parsed.findNameOf(parsed[i]) );
+   }
+   BOOST_CHECK_CLOSE( direct.totalLength(), parsed.totalLength(), percentageAccuracy );
+   BOOST_CHECK_CLOSE( direct.maxElevation(), parsed.maxElevation(), percentageAccuracy );
+   BOOST_CHECK_EQUAL( gwRoute.toRoute(20, "Named").name(), "Named" );
+}
+
+BOOST_AUTO_TEST_CASE( trackMatchesParsedGPX )
+{
+   const GridWorldTrack gwTrack("A3B2B2C1H5H7M0M9Y", 10, 1000, GridWorld(Earth::CityCampus, 500, 7));
+   const seconds logInterval = 5;
+   const Track parsed(gwTrack.toGPX(logInterval), isFileName);
+   const Track direct = gwTrack.toTrack(logInterval);
+
+   BOOST_CHECK_EQUAL( direct.name(), parsed.name() );
+   BOOST_CHECK_EQUAL( direct.numPositions(), parsed.numPositions() );
+   BOOST_CHECK_EQUAL( direct.totalTime(), parsed.totalTime() );
+   BOOST_CHECK_EQUAL( direct.restingTime(), parsed.restingTime() );
+   BOOST_CHECK( direct.restingTime() > 0 );
+   BOOST_CHECK_CLOSE( direct.totalLength(), parsed.totalLength(), percentageAccuracy );
+   BOOST_CHECK_CLOSE( direct.maxSpeed(), parsed.maxSpeed(), speedPercentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( granularityIsApplied )
+{
+   const GridWorldRoute gwRoute("ABCDE", GridWorld(Earth::Pontianak, 100));
+   BOOST_CHECK_EQUAL( gwRoute.toRoute(50).numPositions(), 5 );
+   BOOST_CHECK_EQUAL( gwRoute.toRoute(150).numPositions(), 3 );
+
+   const GridWorldTrack gwTrack("A10B", 10, 0, GridWorld(Earth::Pontianak, 100));
+   BOOST_CHECK_EQUAL( gwTrack.toTrack(10, 5).numPositions(), 11 );
+   BOOST_CHECK_EQUAL( gwTrack.toTrack(10, 25).numPositions(), 4 );
+}
+
+BOOST_AUTO_TEST_CASE( mismatchedInputsThrow )
+{
+   const std::vector<Position> positions = {Earth::CityCampus, Earth::CliftonCampus};
+   BOOST_CHECK_EQUAL( Route(positions, {}).numPositions(), 2 );
+   BOOST_CHECK_THROW( Route(positions, {"City"}), std::invalid_argument );
+   BOOST_CHECK_THROW( Track(positions, {0}), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
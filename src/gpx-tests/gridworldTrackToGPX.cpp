@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+#include "types.h"
+#include "xmlgenerator.h"
+#include "gridworld_track.h"
+
+using namespace GPS;
+
+/* GridWorldTrack.toGPX() can either return the GPX as a string, or stream it through an
+ * XML::Generator::Sink, and can generate track segments in parallel.  These tests check that
+ * all of these produce identical documents, including documents far larger than the
+ * Generator's internal buffer.
+ */
+
+BOOST_AUTO_TEST_SUITE( GridWorldTrack_toGPX )
+
+const GridWorldTrack longTrack = GridWorldTrack("A9B9C9H9M9N9S9Y", 100, 0, GridWorld(Earth::CliftonCampus, 1000, 5));
+
+BOOST_AUTO_TEST_CASE( stringSinkMatchesString )
+{
+   std::string streamed;
+   longTrack.toGPX(XML::Generator::stringSink(streamed), 1);
+   BOOST_CHECK( streamed.length() > 100000 );
+   BOOST_CHECK( streamed == longTrack.toGPX(1) );
+}
+
+BOOST_AUTO_TEST_CASE( callbackSinkReceivesBoundedChunks )
+{
+   std::string streamed;
+   std::size_t largestChunk = 0;
+   longTrack.toGPX([&] (const char * data, std::size_t length)
+   {
+       largestChunk = std::max(largestChunk, length);
+       streamed.append(data, length);
+   }, 10, false);
+
+   BOOST_CHECK( largestChunk <= 4096 );
+   BOOST_CHECK( streamed == longTrack.toGPX(10, false) );
+}
+
+BOOST_AUTO_TEST_CASE( fileDescriptorSinkMatchesString )
+{
+   std::FILE * file = std::tmpfile();
+   BOOST_REQUIRE( file != nullptr );
+   longTrack.toGPX(XML::Generator::fileDescriptorSink(fileno(file)), 5, true, "Long track");
+
+   std::string streamed;
+   std::rewind(file);
+   char buffer[4096];
+   std::size_t count;
+   while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) streamed.append(buffer, count);
+   std::fclose(file);
+
+   BOOST_CHECK( streamed == longTrack.toGPX(5, true, "Long track") );
+}
+
+BOOST_AUTO_TEST_CASE( cannotExtractStringFromSink )
+{
+   std::string destination;
+   XML::Generator gpx(XML::Generator::stringSink(destination));
+   gpx.element("name", "", "A");
+   BOOST_CHECK_THROW( gpx.closeAllElementsAndExtractString(), std::domain_error );
+}
+
+// Compact output is the indented output with the indentation and newlines removed.
+BOOST_AUTO_TEST_CASE( compactOmitsLayout )
+{
+   std::string indented = longTrack.toGPX(20);
+   std::string compact = longTrack.toGPX(20, true, "", true);
+
+   std::string stripped;
+   bool atLineStart = true;
+   for (char c : indented)
+   {
+       if (c == '\n') { atLineStart = true; continue; }
+       if (atLineStart && c == ' ') continue;
+       atLineStart = false;
+       stripped += c;
+   }
+
+   BOOST_CHECK( compact.find('\n') == std::string::npos );
+   BOOST_CHECK( compact == stripped );
+}
+
+// Segments generated in parallel are inserted in order, giving exactly the sequential output.
+BOOST_AUTO_TEST_CASE( parallelMatchesSequential )
+{
+   std::string trackString = "A";
+   for (unsigned int lap = 0; lap < 50; ++lap) trackString += "9B9C9H9M9N9S9R9Q9L9G9F9A";
+   const GridWorldTrack manySegments(trackString, 10, 1000, GridWorld(Earth::CityCampus, 500, 3));
+   const seconds logInterval = 1;
+
+   for (bool compact : {false, true})
+   {
+       const std::string sequential = manySegments.toGPX(logInterval, true, "", compact);
+       BOOST_CHECK( manySegments.toGPX(logInterval, true, "", compact, 2) == sequential );
+       BOOST_CHECK( manySegments.toGPX(logInterval, true, "", compact, 3) == sequential );
+       BOOST_CHECK( manySegments.toGPX(logInterval, true, "", compact, 0) == sequential );
+
+       std::string streamed;
+       manySegments.toGPX(XML::Generator::stringSink(streamed), logInterval, true, "", compact, 4);
+       BOOST_CHECK( streamed == sequential );
+   }
+
+   BOOST_CHECK( longTrack.toGPX(1, false, "", false, 8) == longTrack.toGPX(1, false) );
+   BOOST_CHECK( GridWorldTrack("A").toGPX(1, true, "", false, 4) == GridWorldTrack("A").toGPX(1) );
+}
+
+// A fragment is indented to fit where it will be inserted.
+BOOST_AUTO_TEST_CASE( fragmentsMatchInlineElements )
+{
+   XML::Generator inlined(2);
+   inlined.openElement("gpx", "");
+   inlined.openElement("trk", "");
+   inlined.element("name", "", "Track");
+   inlined.closeAllElements();
+
+   XML::Generator withFragment(2);
+   withFragment.openElement("gpx", "");
+   withFragment.openElement("trk", "");
+   XML::Generator fragment = withFragment.fragment();
+   fragment.element("name", "", "Track");
+   withFragment.insert(fragment.closeAllElementsAndExtractString());
+
+   BOOST_CHECK_EQUAL( withFragment.closeAllElementsAndExtractString(), inlined.closeAllElementsAndExtractString() );
+}
+
+BOOST_AUTO_TEST_CASE( nestingDepthIsBounded )
+{
+   XML::Generator gpx;
+   for (std::size_t depth = 0; depth < XML::Generator::maxDepth; ++depth)
+   {
+       gpx.openElement("trkseg", "");
+   }
+   BOOST_CHECK_THROW( gpx.openElement("trkseg", ""), std::domain_error );
+   gpx.closeAllElements();
+   BOOST_CHECK_THROW( gpx.closeElement(), std::domain_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
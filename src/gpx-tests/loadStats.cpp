@@ -0,0 +1,84 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <sstream>
+
+#include "logs.h"
+#include "earth.h"
+#include "types.h"
+#include "route.h"
+#include "track.h"
+
+using namespace GPS;
+
+/* Routes and Tracks record counters (and, if enabled, timings) for their construction,
+ * available through loadStats() and summarised in buildReport().
+ */
+
+BOOST_AUTO_TEST_SUITE( Route_loadStats )
+
+const bool isFileName = true;
+
+std::size_t fileLength(const std::string & path)
+{
+   std::ifstream file(path);
+   std::ostringstream contents;
+   std::string line;
+   while (getline(file, line)) contents << line << '\n';
+   return contents.str().length();
+}
+
+BOOST_AUTO_TEST_CASE( routeCounters )
+{
+   const std::string path = LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx";
+   const Route route(path, isFileName);
+   const LoadStats & stats = route.loadStats();
+
+   BOOST_CHECK_EQUAL( stats.pointsSeen, 1091 );
+   BOOST_CHECK_EQUAL( stats.pointsAccepted, route.numPositions() );
+   BOOST_CHECK_EQUAL( stats.pointsAccepted + stats.pointsIgnored, stats.pointsSeen );
+   BOOST_CHECK( stats.pointsIgnored > 0 );
+   BOOST_CHECK_EQUAL( stats.bytesScanned, fileLength(path) );
+}
+
+BOOST_AUTO_TEST_CASE( trackCounters )
+{
+   const Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   const LoadStats & stats = track.loadStats();
+
+   BOOST_CHECK_EQUAL( stats.pointsAccepted, track.numPositions() );
+   BOOST_CHECK_EQUAL( stats.pointsAccepted + stats.pointsIgnored, stats.pointsSeen );
+   BOOST_CHECK( stats.bytesScanned > 0 );
+}
+
+BOOST_AUTO_TEST_CASE( inMemoryConstructionScansNoBytes )
+{
+   const Route route(std::vector<Position>{Earth::CityCampus, Earth::CityCampus, Earth::CliftonCampus});
+   BOOST_CHECK_EQUAL( route.loadStats().pointsSeen, 3 );
+   BOOST_CHECK_EQUAL( route.loadStats().pointsIgnored, 1 );
+   BOOST_CHECK_EQUAL( route.loadStats().bytesScanned, 0 );
+   BOOST_CHECK_EQUAL( route.loadStats().readFile.count(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( timingsFollowTheCompileTimeSwitch )
+{
+   const Route route(LogFiles::GPXRoutesDir + "NottinghamToLondon.gpx", isFileName);
+   const LoadStats & stats = route.loadStats();
+   const std::string report = route.buildReport();
+
+   BOOST_CHECK( report.find("Points seen: 2431") != std::string::npos );
+   if (LoadStats::timingsEnabled)
+   {
+       BOOST_CHECK( stats.readFile.count() > 0 );
+       BOOST_CHECK( stats.pointLoop.count() > 0 );
+       BOOST_CHECK( report.find("Load timings (ns)") != std::string::npos );
+   }
+   else
+   {
+       BOOST_CHECK_EQUAL( stats.readFile.count(), 0 );
+       BOOST_CHECK_EQUAL( stats.pointLoop.count(), 0 );
+       BOOST_CHECK( report.find("Load timings") == std::string::npos );
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
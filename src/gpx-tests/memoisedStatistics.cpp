@@ -0,0 +1,116 @@
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "logs.h"
+#include "types.h"
+#include "route.h"
+#include "track.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( MemoisedStatistics )
+
+const bool isFileName = true;
+
+BOOST_AUTO_TEST_CASE( repeatedQueriesAgree )
+{
+   const Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   const Route & route = track;
+
+   const degrees maxGradient = route.maxGradient();
+   const metres minElevation = route.minElevation();
+   const seconds restingTime = track.restingTime();
+   const speed maxSpeed = track.maxSpeed();
+   for (int i = 0; i < 3; ++i)
+   {
+      BOOST_CHECK_EQUAL( route.maxGradient(), maxGradient );
+      BOOST_CHECK_EQUAL( route.minElevation(), minElevation );
+      BOOST_CHECK_EQUAL( track.restingTime(), restingTime );
+      BOOST_CHECK_EQUAL( track.maxSpeed(), maxSpeed );
+   }
+   BOOST_CHECK_EQUAL( track.travellingTime() + track.restingTime(), track.totalTime() );
+}
+
+BOOST_AUTO_TEST_CASE( concurrentFirstQueriesAgree )
+{
+   const Route expected(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   const Route route(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+
+   const unsigned int numThreads = 8;
+   std::vector<degrees> maxLatitudes(numThreads);
+   std::vector<degrees> steepestGradients(numThreads);
+   std::vector<std::thread> threads;
+   for (unsigned int t = 0; t < numThreads; ++t)
+   {
+      threads.emplace_back([&, t] ()
+      {
+         maxLatitudes[t] = route.maxLatitude();
+         steepestGradients[t] = route.steepestGradient();
+      });
+   }
+   for (std::thread & thread : threads) thread.join();
+
+   for (unsigned int t = 0; t < numThreads; ++t)
+   {
+      BOOST_CHECK_EQUAL( maxLatitudes[t], expected.maxLatitude() );
+      BOOST_CHECK_EQUAL( steepestGradients[t], expected.steepestGradient() );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( setGranularityInvalidatesRouteStatistics )
+{
+   Route route(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   const unsigned int initialPositions = route.numPositions();
+   const metres initialHeightGain = route.totalHeightGain();
+   const degrees initialMaxGradient = route.maxGradient();
+
+   std::vector<Position> positions;
+   for (unsigned int i = 0; i < route.numPositions(); ++i) positions.push_back(route[i]);
+
+   const metres coarse = 2000;
+   route.setGranularity(coarse);
+   const Route expected(positions, {}, route.name(), coarse);
+
+   BOOST_CHECK_LT( route.numPositions(), initialPositions );
+   BOOST_CHECK_EQUAL( route.numPositions(), expected.numPositions() );
+   BOOST_CHECK_EQUAL( route.totalLength(), expected.totalLength() );
+   BOOST_CHECK_EQUAL( route.totalHeightGain(), expected.totalHeightGain() );
+   BOOST_CHECK_EQUAL( route.maxGradient(), expected.maxGradient() );
+   BOOST_CHECK_EQUAL( route.minElevation(), expected.minElevation() );
+   BOOST_CHECK( route.totalHeightGain() != initialHeightGain || route.maxGradient() != initialMaxGradient );
+
+   route.setGranularity(1000000);
+   BOOST_CHECK_EQUAL( route.numPositions(), 1 );
+   BOOST_CHECK_EQUAL( route.totalLength(), 0 );
+   BOOST_CHECK_EQUAL( route.maxGradient(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( setGranularityMergesTrackTimes )
+{
+   Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   const unsigned int initialPositions = track.numPositions();
+   const seconds totalTime = track.totalTime();
+   const seconds initialRestingTime = track.restingTime();
+
+   track.setGranularity(100000);
+   BOOST_CHECK_LT( track.numPositions(), initialPositions );
+   BOOST_CHECK_EQUAL( track.totalTime(), totalTime );
+   BOOST_CHECK_GT( track.restingTime(), initialRestingTime );
+   BOOST_CHECK_EQUAL( track.travellingTime() + track.restingTime(), totalTime );
+
+   track.setGranularity(1000000);
+   BOOST_CHECK_EQUAL( track.numPositions(), 1 );
+   BOOST_CHECK_EQUAL( track.restingTime(), totalTime );
+   BOOST_CHECK_EQUAL( track.maxSpeed(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( setGranularityIsReported )
+{
+   Route route(LogFiles::GPXRoutesDir + "ABCD.gpx", isFileName);
+   route.setGranularity(1000000);
+   BOOST_CHECK( route.buildReport().find("Granularity set to 1e+06m") != std::string::npos );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,58 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "earth.h"
+#include "types.h"
+#include "route.h"
+#include "track.h"
+
+using namespace GPS;
+
+/* Route::memoryUsage() and Track::memoryUsage() account for the memory held by each
+ * member, including heap-allocated name strings.
+ */
+
+BOOST_AUTO_TEST_SUITE( Route_memoryUsage )
+
+const bool isFileName = true;
+
+BOOST_AUTO_TEST_CASE( routeComponents )
+{
+   const Route route(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   const MemoryUsage usage = route.memoryUsage();
+
+   BOOST_CHECK( usage.object >= sizeof(Route) );
+   BOOST_CHECK( usage.positions >= route.numPositions() * sizeof(Position) );
+   BOOST_CHECK( usage.positionNames >= route.numPositions() * sizeof(std::string) );
+   BOOST_CHECK_EQUAL( usage.times, 0 );
+   BOOST_CHECK( usage.report >= route.buildReport().length() );
+   BOOST_CHECK_EQUAL( usage.total(), usage.object + usage.positions + usage.positionNames
+                                     + usage.times + usage.report + usage.caches + usage.rangeIndex );
+}
+
+BOOST_AUTO_TEST_CASE( longNamesAreCounted )
+{
+   const std::vector<Position> positions = {Earth::CityCampus, Earth::CliftonCampus};
+   const std::string longName(1000, 'N');
+   const Route shortNames(positions, {"A", "B"});
+   const Route longNames(positions, {longName, longName});
+
+   BOOST_CHECK( longNames.memoryUsage().positionNames >= shortNames.memoryUsage().positionNames + 2 * longName.length() );
+   BOOST_CHECK_EQUAL( longNames.memoryUsage().positions, shortNames.memoryUsage().positions );
+}
+
+BOOST_AUTO_TEST_CASE( trackTimesAreCounted )
+{
+   const Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   const MemoryUsage usage = track.memoryUsage();
+   const Route & asRoute = track;
+
+   BOOST_CHECK( usage.object >= sizeof(Track) );
+   BOOST_CHECK( usage.times >= 2 * track.numPositions() * sizeof(seconds) );
+   BOOST_CHECK_EQUAL( asRoute.memoryUsage().total(), usage.total() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+#include <boost/test/unit_test.hpp>
+
+#include <exception>
+#include <string>
+
+#include "types.h"
+#include "route.h"
+#include "track.h"
+#include "workload.h"
+
+using namespace GPS;
+
+/* Parsing GPX data on several threads should give exactly the same Route or Track as
+ * parsing it on one thread, including the build report, and any exception thrown.
+ */
+
+BOOST_AUTO_TEST_SUITE( ParallelParse )
+
+const bool isFileName = false;
+const unsigned int threads = 4;
+
+// A track with rests and repeated points, large enough to be split into several chunks.
+std::string largeTrackGPX()
+{
+   Workload::Options options;
+   options.seed = 43;
+   options.gridSize = 21;
+   options.fileSize = 400000;
+   options.restProbability = 0.2;
+   options.duplicateProbability = 0.1;
+   std::string gpx;
+   Workload::trackFor(options, 0).toGPX(XML::Generator::stringSink(gpx), options.logInterval);
+   return gpx;
+}
+
+std::string largeRouteGPX()
+{
+   std::string gpx = largeTrackGPX();
+   for (auto replacement : { std::pair<std::string,std::string>{"<trkpt", "<rtept"}, {"</trkpt>", "</rtept>"},
+                             {"<trk>", "<rte>"}, {"</trk>", "</rte>"} })
+   {
+      for (std::size_t pos = gpx.find(replacement.first); pos != std::string::npos;
+           pos = gpx.find(replacement.first, pos + replacement.second.length()))
+      {
+         gpx.replace(pos, replacement.first.length(), replacement.second);
+      }
+   }
+   return gpx;
+}
+
+void checkSameRoute(const Route & sequential, const Route & parallel)
+{
+   BOOST_REQUIRE_EQUAL( sequential.numPositions(), parallel.numPositions() );
+   for (unsigned int i = 0; i < sequential.numPositions(); ++i)
+   {
+      BOOST_CHECK_EQUAL( sequential[i].latitude(), parallel[i].latitude() );
+      BOOST_CHECK_EQUAL( sequential[i].longitude(), parallel[i].longitude() );
+      BOOST_CHECK_EQUAL( sequential[i].elevation(), parallel[i].elevation() );
+   }
+   BOOST_CHECK_EQUAL( sequential.totalLength(), parallel.totalLength() );
+   BOOST_CHECK_EQUAL( sequential.loadStats().pointsIgnored, parallel.loadStats().pointsIgnored );
+   // The report also records which points were ignored, and any load timings, which will differ.
+   const std::string report = sequential.buildReport();
+   const std::string parallelReport = parallel.buildReport();
+   BOOST_CHECK( report.substr(0, report.find("Load timings")) == parallelReport.substr(0, parallelReport.find("Load timings")) );
+}
+
+BOOST_AUTO_TEST_CASE( tracksMatch )
+{
+   const std::string gpx = largeTrackGPX();
+   for (metres granularity : {1.0, 10.0, 150.0, 1000.0})
+   {
+      const Track sequential(gpx, isFileName, granularity);
+      const Track parallel(gpx, isFileName, granularity, threads);
+
+      BOOST_CHECK( sequential.loadStats().pointsIgnored > 0 );
+      checkSameRoute(sequential, parallel);
+      BOOST_CHECK_EQUAL( sequential.totalTime(), parallel.totalTime() );
+      BOOST_CHECK_EQUAL( sequential.restingTime(), parallel.restingTime() );
+      BOOST_CHECK_EQUAL( sequential.maxSpeed(), parallel.maxSpeed() );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( routesMatch )
+{
+   const std::string gpx = largeRouteGPX();
+   for (metres granularity : {20.0, 250.0})
+   {
+      const Route sequential(gpx, isFileName, granularity);
+      const Route parallel(gpx, isFileName, granularity, threads);
+
+      checkSameRoute(sequential, parallel);
+      const unsigned int middle = sequential.numPositions() / 2;
+      BOOST_CHECK_EQUAL( sequential.findNameOf(sequential[middle]), parallel.findNameOf(parallel[middle]) );
+   }
+}
+
+// The build report of a Track, or the message of the exception its construction threw.
+std::string outcome(const std::string & gpx, unsigned int threads)
+{
+   try
+   {
+      const std::string report = Track(gpx, isFileName, 10, threads).buildReport();
+      return report.substr(0, report.find("Load timings"));
+   }
+   catch (const std::exception & e)
+   {
+      return std::string("Exception: ") + e.what();
+   }
+}
+
+BOOST_AUTO_TEST_CASE( illFormedPointsMatch )
+{
+   const std::string gpx = largeTrackGPX();
+
+   // A point without a longitude, and (later) one without a time.
+   std::string noLongitude = gpx;
+   noLongitude.erase(noLongitude.find(" lon=", gpx.length() * 2 / 3), 5);
+   noLongitude.erase(noLongitude.find("<time>", gpx.length() * 5 / 6), 6);
+   BOOST_CHECK_EQUAL( outcome(noLongitude, threads), outcome(noLongitude, 1) );
+   BOOST_CHECK_EQUAL( outcome(noLongitude, threads), "Exception: No 'lon' attribute." );
+
+   // A point without a closing tag, so that it extends into the next point (and perhaps the next chunk).
+   for (std::size_t fraction = 1; fraction < 8; ++fraction)
+   {
+      std::string unclosed = gpx;
+      unclosed.erase(unclosed.find("</trkpt>", gpx.length() * fraction / 8), 8);
+      BOOST_CHECK_EQUAL( outcome(unclosed, threads), outcome(unclosed, 1) );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( smallDataIsParsedSequentially )
+{
+   const std::string gpx = "<gpx><trk><trkseg><trkpt lat=\"1\" lon=\"2\"><time>0</time></trkpt>"
+                           "<trkpt lat=\"1\" lon=\"3\"><time>60</time></trkpt></trkseg></trk></gpx>";
+   BOOST_CHECK_EQUAL( Track(gpx, isFileName, 10, threads).numPositions(), 2 );
+   BOOST_CHECK_EQUAL( Track(gpx, isFileName, 10, 0).numPositions(), 2 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+#include "types.h"
+#include "route.h"
+#include "track.h"
+#include "workload.h"
+#include "allocationcounter.h"
+
+using namespace GPS;
+
+/* Constructing a Track from GPX data passed as an rvalue string should not copy the data at all,
+ * and from a file name or a string_view should copy it (or read it) only once.
+ * The peak heap usage during construction is compared with the memory the Track holds afterwards
+ * (mostly its points and build report), plus the copies allowed, with a quarter of the GPX size to
+ * spare.  Copying the GPX data any more often would exceed this.
+ */
+
+BOOST_AUTO_TEST_SUITE( PeakMemory )
+
+const bool isFileName = true;
+
+std::string largeTrackGPX()
+{
+   Workload::Options options;
+   options.seed = 44;
+   options.gridSize = 51;
+   options.fileSize = 1000000;
+   std::string gpx;
+   Workload::trackFor(options, 0).toGPX(XML::Generator::stringSink(gpx), options.logInterval);
+   gpx.shrink_to_fit();
+   return gpx;
+}
+
+BOOST_AUTO_TEST_CASE( movedGPXIsNotCopied )
+{
+   std::string gpx = largeTrackGPX();
+   const std::size_t gpxSize = gpx.length();
+
+   AllocationCounter counter;
+   const Track track(std::move(gpx), ! isFileName);
+   const std::size_t peak = counter.peakBytes();
+
+   BOOST_REQUIRE( track.numPositions() > 1000 );
+   BOOST_CHECK_LE( peak, track.memoryUsage().total() + gpxSize / 4 );
+}
+
+BOOST_AUTO_TEST_CASE( viewedGPXIsCopiedOnce )
+{
+   const std::string gpx = largeTrackGPX();
+
+   AllocationCounter counter;
+   const Track track(std::string_view(gpx), ! isFileName);
+   const std::size_t peak = counter.peakBytes();
+
+   BOOST_CHECK_LE( peak, track.memoryUsage().total() + gpx.length() + gpx.length() / 4 );
+   BOOST_CHECK( track.buildReport() == Track(std::string(gpx), ! isFileName).buildReport() );
+}
+
+BOOST_AUTO_TEST_CASE( fileIsReadOnce )
+{
+   const std::string gpx = largeTrackGPX();
+   char fileName[] = "/tmp/gpx-testsXXXXXX";
+   const int fileDescriptor = ::mkstemp(fileName);
+   BOOST_REQUIRE( fileDescriptor >= 0 );
+   ::close(fileDescriptor);
+   std::ofstream(fileName) << gpx;
+
+   AllocationCounter counter;
+   const Track track(fileName, isFileName);
+   const std::size_t peak = counter.peakBytes();
+   std::remove(fileName);
+
+   BOOST_CHECK_LE( peak, track.memoryUsage().total() + gpx.length() + gpx.length() / 4 );
+   BOOST_CHECK_EQUAL( track.loadStats().bytesScanned, gpx.length() + (gpx.back() == '\n' ? 0 : 1) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
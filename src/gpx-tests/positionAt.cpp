@@ -0,0 +1,153 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include "types.h"
+#include "earth.h"
+#include "track.h"
+#include "gridworld_track.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( PositionAt )
+
+const degrees degreesTolerance = 0.000001;
+const metres metresTolerance = 0.001;
+
+void checkSamePosition(const Position & actual, const Position & expected)
+{
+   BOOST_CHECK_SMALL( actual.latitude() - expected.latitude(), degreesTolerance );
+   BOOST_CHECK_SMALL( actual.longitude() - expected.longitude(), degreesTolerance );
+   BOOST_CHECK_SMALL( actual.elevation() - expected.elevation(), metresTolerance );
+}
+
+// At A at time 0, arrives at B at time 10, rests there until 20, then arrives at C at 30.
+Track restingTrack()
+{
+   const Position a(0, 0, 100);
+   const Position b(0.01, 0.02, 200);
+   const Position c(0.03, 0.02, 100);
+   return Track({a, b, b, c}, {0, 10, 20, 30});
+}
+
+BOOST_AUTO_TEST_CASE( pointsRestsAndInterpolation )
+{
+   const Track track = restingTrack();
+
+   checkSamePosition( track.positionAt(0), track[0] );
+   checkSamePosition( track.positionAt(5), Position(0.005, 0.01, 150) );
+   checkSamePosition( track.positionAt(10), track[1] );
+   checkSamePosition( track.positionAt(15), track[1] );
+   checkSamePosition( track.positionAt(20), track[1] );
+   checkSamePosition( track.positionAt(23), Position(0.016, 0.02, 170) );
+   checkSamePosition( track.positionAt(30), track[2] );
+}
+
+BOOST_AUTO_TEST_CASE( timesOutsideTheTrackThrow )
+{
+   const Track track = restingTrack();
+   BOOST_CHECK_THROW( track.positionAt(31), std::out_of_range );
+   BOOST_CHECK_THROW( track.positionsAt({29, 30, 31}), std::out_of_range );
+
+   const Track empty(std::vector<Position>{}, std::vector<seconds>{});
+   BOOST_CHECK_THROW( empty.positionAt(0), std::out_of_range );
+   BOOST_CHECK( empty.positionsAt({}).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( batchMatchesSingleLookups )
+{
+   const Track track = restingTrack();
+   std::vector<seconds> times;
+   for (seconds t = 0; t <= 30; ++t) times.push_back(t);
+   times.push_back(30);
+
+   const std::vector<Position> batch = track.positionsAt(times);
+   BOOST_REQUIRE_EQUAL( batch.size(), times.size() );
+   for (std::size_t i = 0; i < times.size(); ++i) checkSamePosition( batch[i], track.positionAt(times[i]) );
+
+   BOOST_CHECK_THROW( track.positionsAt({10, 5}), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( shorterWayAroundTheAntimeridian )
+{
+   const Track track({Position(10, 179.9), Position(10, -179.7)}, {0, 100});
+
+   checkSamePosition( track.positionAt(50), Position(10, -179.9) );
+   checkSamePosition( track.positionAt(75), Position(10, -179.8) );
+}
+
+BOOST_AUTO_TEST_CASE( matchesAFinerlyLoggedTrack )
+{
+   const GridWorldTrack route("A1B3C2H", 10, 0, GridWorld(Earth::CityCampus, 1000, 10));
+   const metres noGranularity = 0;
+   const Track coarse = route.toTrack(5, noGranularity);
+   const Track fine = route.toTrack(1, noGranularity);
+
+   std::vector<seconds> times;
+   for (seconds t = 0; t <= coarse.totalTime(); t += 2) times.push_back(t);
+   const std::vector<Position> positions = coarse.positionsAt(times);
+   for (std::size_t i = 0; i < times.size(); ++i) checkSamePosition( positions[i], fine.positionAt(times[i]) );
+}
+
+// Track::resampled() places each of its points at the positionAt() its time.
+
+BOOST_AUTO_TEST_CASE( resampledAtFixedIntervals )
+{
+   const Track track = restingTrack();
+   const Track resampled = track.resampled(5);
+
+   // Points are kept while resting too.
+   BOOST_REQUIRE_EQUAL( resampled.numPositions(), 7 );
+   for (unsigned int i = 0; i < resampled.numPositions(); ++i)
+   {
+      checkSamePosition( resampled[i], track.positionAt(5 * i) );
+      BOOST_CHECK_EQUAL( resampled.totalTime(i, i), 0 );
+   }
+   BOOST_CHECK_EQUAL( resampled.totalTime(), track.totalTime() );
+   BOOST_CHECK_EQUAL( resampled.restingTime(), 0 );
+   BOOST_CHECK_EQUAL( resampled.name(), track.name() );
+}
+
+BOOST_AUTO_TEST_CASE( resampledAtIntervalsThatDoNotDivideTheTrack )
+{
+   const Track resampled = restingTrack().resampled(7);
+   BOOST_REQUIRE_EQUAL( resampled.numPositions(), 5 );
+   BOOST_CHECK_EQUAL( resampled.totalTime(), 28 );
+
+   BOOST_CHECK_EQUAL( restingTrack().resampled(100).numPositions(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( resampledInvalidAndEmptyTracks )
+{
+   BOOST_CHECK_THROW( restingTrack().resampled(0), std::invalid_argument );
+
+   const Track empty(std::vector<Position>{}, std::vector<seconds>{});
+   BOOST_CHECK_EQUAL( empty.resampled(10).numPositions(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( resampledAcrossTheAntimeridian )
+{
+   const Track track({Position(10, 179.9), Position(10, -179.7)}, {0, 100});
+   const Track resampled = track.resampled(25);
+
+   BOOST_REQUIRE_EQUAL( resampled.numPositions(), 5 );
+   for (unsigned int i = 0; i < resampled.numPositions(); ++i)
+   {
+      BOOST_CHECK( resampled[i].longitude() > 179.85 || resampled[i].longitude() < -179.65 );
+   }
+   checkSamePosition( resampled[3], Position(10, -179.8) );
+}
+
+BOOST_AUTO_TEST_CASE( resampledMatchesAFinerlyLoggedTrack )
+{
+   const GridWorldTrack route("A1B3C2H", 10, 0, GridWorld(Earth::CityCampus, 1000, 10));
+   const metres noGranularity = 0;
+   const Track fine = route.toTrack(1, noGranularity);
+   const Track resampled = route.toTrack(10, noGranularity).resampled(1);
+
+   BOOST_REQUIRE_EQUAL( resampled.numPositions(), fine.totalTime() + 1 );
+   for (unsigned int i = 0; i < resampled.numPositions(); ++i) checkSamePosition( resampled[i], fine.positionAt(i) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
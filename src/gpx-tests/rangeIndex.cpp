@@ -0,0 +1,108 @@
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "logs.h"
+#include "types.h"
+#include "route.h"
+#include "track.h"
+#include "sparsetable.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( RangeIndex )
+
+const bool isFileName = true;
+
+BOOST_AUTO_TEST_CASE( sparseTableMatchesScanning )
+{
+   const std::vector<int> values = {5, 3, 8, 1, 9, 2, 7, 7, 4, 6, 0};
+   const SparseTable<int> minima(values);
+   const SparseTable<int,std::greater<int>> maxima(values);
+
+   for (std::size_t from = 0; from < values.size(); ++from)
+   {
+      for (std::size_t to = from; to < values.size(); ++to)
+      {
+         int least = values[from];
+         int greatest = values[from];
+         for (std::size_t i = from; i <= to; ++i)
+         {
+            least = std::min(least, values[i]);
+            greatest = std::max(greatest, values[i]);
+         }
+         BOOST_CHECK_EQUAL( minima.query(from, to), least );
+         BOOST_CHECK_EQUAL( maxima.query(from, to), greatest );
+      }
+   }
+}
+
+void checkRangesAgreeWith(const Route & indexed, const Route & scanned)
+{
+   const unsigned int last = indexed.numPositions() - 1;
+   for (unsigned int from : {0U, 1U, last / 3, last / 2, last})
+   {
+      for (unsigned int to : {from, from + 1, last / 2 + 5, last})
+      {
+         if (to < from || to > last) continue;
+         BOOST_CHECK_EQUAL( indexed.minLatitude(from, to), scanned.minLatitude(from, to) );
+         BOOST_CHECK_EQUAL( indexed.maxLatitude(from, to), scanned.maxLatitude(from, to) );
+         BOOST_CHECK_EQUAL( indexed.minLongitude(from, to), scanned.minLongitude(from, to) );
+         BOOST_CHECK_EQUAL( indexed.maxLongitude(from, to), scanned.maxLongitude(from, to) );
+         BOOST_CHECK_EQUAL( indexed.minElevation(from, to), scanned.minElevation(from, to) );
+         BOOST_CHECK_EQUAL( indexed.maxElevation(from, to), scanned.maxElevation(from, to) );
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE( indexedAndScannedRangesAgree )
+{
+   Route indexed(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   const Route scanned(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   const unsigned int last = scanned.numPositions() - 1;
+
+   BOOST_CHECK( ! indexed.hasRangeIndex() );
+   BOOST_CHECK_EQUAL( indexed.memoryUsage().rangeIndex, 0 );
+   indexed.buildRangeIndex();
+   BOOST_CHECK( indexed.hasRangeIndex() );
+
+   checkRangesAgreeWith(indexed, scanned);
+   BOOST_CHECK_EQUAL( scanned.maxElevation(0, last), scanned.maxElevation() );
+   BOOST_CHECK_EQUAL( scanned.minLongitude(0, last), scanned.minLongitude() );
+}
+
+BOOST_AUTO_TEST_CASE( buildCostIsReported )
+{
+   Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   track.buildRangeIndex();
+
+   // At least one level of six tables of one value per point.
+   BOOST_CHECK_GE( track.memoryUsage().rangeIndex, 6 * track.numPositions() * sizeof(double) );
+   BOOST_CHECK( track.buildReport().find("Range index built: ") != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( indexIsRebuiltWhenThePointsChange )
+{
+   Route indexed(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   Route scanned(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   indexed.buildRangeIndex();
+   const std::size_t initialMemory = indexed.memoryUsage().rangeIndex;
+
+   indexed.setGranularity(500);
+   scanned.setGranularity(500);
+   BOOST_CHECK( indexed.hasRangeIndex() );
+   BOOST_CHECK_LT( indexed.memoryUsage().rangeIndex, initialMemory );
+   checkRangesAgreeWith(indexed, scanned);
+}
+
+BOOST_AUTO_TEST_CASE( invalidRangesThrow )
+{
+   Route route(LogFiles::GPXRoutesDir + "ABCD.gpx", isFileName);
+   route.buildRangeIndex();
+   BOOST_CHECK_THROW( route.minElevation(0, route.numPositions()), std::out_of_range );
+   BOOST_CHECK_THROW( route.maxLatitude(2, 1), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include "logs.h"
+#include "types.h"
+#include "route.h"
+#include "track.h"
+
+using namespace GPS;
+
+/* The range queries are compared with the whole-Route statistics of a Route (or Track) built
+ * from just the points in the range.
+ */
+
+BOOST_AUTO_TEST_SUITE( RangeQueries )
+
+const bool isFileName = true;
+const metres lengthTolerance = 0.0001;
+
+Route subRoute(const Route & route, unsigned int from, unsigned int to)
+{
+   std::vector<Position> positions;
+   for (unsigned int i = from; i <= to; ++i) positions.push_back(route[i]);
+   const metres noGranularity = 0;
+   return Route(positions, {}, "", noGranularity);
+}
+
+BOOST_AUTO_TEST_CASE( wholeRouteRangesMatchTheWholeRoute )
+{
+   const Route route(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   const unsigned int last = route.numPositions() - 1;
+
+   BOOST_CHECK_EQUAL( route.totalLength(0, last), route.totalLength() );
+   BOOST_CHECK_EQUAL( route.totalHeightGain(0, last), route.totalHeightGain() );
+   BOOST_CHECK_EQUAL( route.netHeightGain(0, last), route.netHeightGain() );
+}
+
+BOOST_AUTO_TEST_CASE( subRangesMatchSubRoutes )
+{
+   const Route route(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   const unsigned int last = route.numPositions() - 1;
+
+   for (unsigned int from : {0U, 1U, last / 3, last / 2})
+   {
+      for (unsigned int to : {from, from + 1, last / 2 + 3, last})
+      {
+         const Route part = subRoute(route, from, to);
+         BOOST_CHECK_CLOSE_FRACTION( route.totalLength(from, to) + 1, part.totalLength() + 1, lengthTolerance );
+         BOOST_CHECK_CLOSE_FRACTION( route.totalHeightGain(from, to) + 1, part.totalHeightGain() + 1, lengthTolerance );
+         BOOST_CHECK_EQUAL( route.netHeightGain(from, to), part.netHeightGain() );
+      }
+   }
+   BOOST_CHECK_EQUAL( route.totalLength(3, 3), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( invalidRangesThrow )
+{
+   const Route route(LogFiles::GPXRoutesDir + "ABCD.gpx", isFileName);
+   const unsigned int last = route.numPositions() - 1;
+
+   BOOST_CHECK_THROW( route.totalLength(0, last + 1), std::out_of_range );
+   BOOST_CHECK_THROW( route.totalHeightGain(2, 1), std::out_of_range );
+   BOOST_CHECK_THROW( route.netHeightGain(last + 1, last + 1), std::out_of_range );
+
+   const Route empty(std::vector<Position>{});
+   BOOST_CHECK_THROW( empty.totalLength(0, 0), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( trackTimeRanges )
+{
+   const Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   const unsigned int last = track.numPositions() - 1;
+
+   BOOST_CHECK_EQUAL( track.totalTime(0, last), track.totalTime() );
+   BOOST_CHECK_EQUAL( track.restingTime(0, last), track.restingTime() );
+   BOOST_CHECK_EQUAL( track.travellingTime(0, last), track.travellingTime() );
+
+   // Consecutive ranges overlap at the shared point, so its resting time is counted twice.
+   const unsigned int middle = last / 2;
+   BOOST_CHECK_EQUAL( track.restingTime(0, middle) + track.restingTime(middle, last),
+                      track.restingTime() + track.restingTime(middle, middle) );
+   BOOST_CHECK_EQUAL( track.totalTime(middle, middle), track.restingTime(middle, middle) );
+   BOOST_CHECK_EQUAL( track.travellingTime(middle, middle), 0 );
+   BOOST_CHECK_EQUAL( track.travellingTime(0, middle) + track.travellingTime(middle, last), track.travellingTime() );
+   BOOST_CHECK_THROW( track.restingTime(0, last + 1), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( prefixSumsFollowGranularityChanges )
+{
+   Route route(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   route.totalLength(0, 1);
+   const std::size_t cachesBefore = route.memoryUsage().caches;
+
+   route.setGranularity(1000);
+   const unsigned int last = route.numPositions() - 1;
+   BOOST_CHECK_LT( route.memoryUsage().caches, cachesBefore );
+   BOOST_CHECK_EQUAL( route.totalLength(0, last), route.totalLength() );
+   BOOST_CHECK_EQUAL( route.totalHeightGain(0, last), route.totalHeightGain() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "logs.h"
+#include "types.h"
+#include "route.h"
+#include "track.h"
+#include "routecollection.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( RouteCollectionLoadDirectory )
+
+const bool isFileName = true;
+
+BOOST_AUTO_TEST_CASE( sameRoutesAsLoadingEachFile )
+{
+   const RouteCollection routes = RouteCollection::loadDirectory(LogFiles::GPXRoutesDir, 4);
+   BOOST_REQUIRE( routes.size() > 0 );
+
+   for (std::size_t i = 0; i < routes.size(); ++i)
+   {
+      if (i > 0) BOOST_CHECK( routes.fileName(i-1) < routes.fileName(i) );
+
+      const Route route(LogFiles::GPXRoutesDir + routes.fileName(i), isFileName);
+      BOOST_CHECK_EQUAL( routes[i].name(), route.name() );
+      BOOST_CHECK_EQUAL( routes[i].numPositions(), route.numPositions() );
+      BOOST_CHECK_EQUAL( routes[i].totalLength(), route.totalLength() );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( orderIndependentOfThreads )
+{
+   const TrackCollection sequential = TrackCollection::loadDirectory(LogFiles::GPXTracksDir, 1);
+   const TrackCollection parallel = TrackCollection::loadDirectory(LogFiles::GPXTracksDir, 3);
+
+   BOOST_REQUIRE_EQUAL( sequential.size(), parallel.size() );
+   for (std::size_t i = 0; i < sequential.size(); ++i)
+   {
+      BOOST_CHECK_EQUAL( sequential.fileName(i), parallel.fileName(i) );
+      BOOST_CHECK_EQUAL( sequential[i].numPositions(), parallel[i].numPositions() );
+   }
+
+   BOOST_REQUIRE_EQUAL( sequential.errors().size(), parallel.errors().size() );
+   for (std::size_t i = 0; i < sequential.errors().size(); ++i)
+   {
+      BOOST_CHECK_EQUAL( sequential.errors()[i].fileName, parallel.errors()[i].fileName );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( errorsDoNotAbortTheBatch )
+{
+   char directory[] = "/tmp/gpx-testsXXXXXX";
+   BOOST_REQUIRE( ::mkdtemp(directory) != nullptr );
+   const std::string dir = directory;
+
+   std::ofstream(dir + "/a.gpx") << "<gpx><rte><name>A</name><rtept lat=\"1\" lon=\"2\"></rtept></rte></gpx>";
+   std::ofstream(dir + "/b.gpx") << "<gpx><rte><rtept lat=\"1\"></rtept></rte></gpx>";
+   std::ofstream(dir + "/c.gpx") << "<gpx><rte><name>C</name><rtept lat=\"3\" lon=\"4\"></rtept></rte></gpx>";
+   std::ofstream(dir + "/notes.txt") << "Not GPX.";
+
+   const RouteCollection routes = RouteCollection::loadDirectory(dir, 2);
+
+   BOOST_REQUIRE_EQUAL( routes.size(), 2 );
+   BOOST_CHECK_EQUAL( routes.fileName(0), "a.gpx" );
+   BOOST_CHECK_EQUAL( routes[0].name(), "A" );
+   BOOST_CHECK_EQUAL( routes.fileName(1), "c.gpx" );
+   BOOST_CHECK_EQUAL( routes[1].name(), "C" );
+   BOOST_REQUIRE_EQUAL( routes.errors().size(), 1 );
+   BOOST_CHECK_EQUAL( routes.errors()[0].fileName, "b.gpx" );
+   BOOST_CHECK_EQUAL( routes.errors()[0].message, "No 'lon' attribute." );
+   BOOST_CHECK_THROW( routes[2], std::out_of_range );
+
+   for (const char * file : {"/a.gpx", "/b.gpx", "/c.gpx", "/notes.txt"}) std::remove((dir + file).c_str());
+   ::rmdir(directory);
+}
+
+BOOST_AUTO_TEST_CASE( emptyAndMissingDirectories )
+{
+   char directory[] = "/tmp/gpx-testsXXXXXX";
+   BOOST_REQUIRE( ::mkdtemp(directory) != nullptr );
+   const RouteCollection routes = RouteCollection::loadDirectory(directory);
+   BOOST_CHECK_EQUAL( routes.size(), 0 );
+   BOOST_CHECK( routes.errors().empty() );
+   ::rmdir(directory);
+
+   BOOST_CHECK_THROW( RouteCollection::loadDirectory(LogFiles::GPXRoutesDir + "NoSuchDirectory"), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
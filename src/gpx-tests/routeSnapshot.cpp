@@ -0,0 +1,119 @@
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "logs.h"
+#include "types.h"
+#include "route.h"
+#include "track.h"
+#include "routesnapshot.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( RouteSnapshots )
+
+const bool isFileName = true;
+
+BOOST_AUTO_TEST_CASE( statisticsMatchTheRoute )
+{
+   const Route route(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName);
+   const std::shared_ptr<const RouteSnapshot> snapshot = RouteSnapshot::of(route);
+   const RouteSnapshot::Statistics & stats = snapshot->statistics();
+
+   BOOST_CHECK_EQUAL( stats.numPositions, route.numPositions() );
+   BOOST_CHECK_EQUAL( stats.totalLength, route.totalLength() );
+   BOOST_CHECK_EQUAL( stats.netLength, route.netLength() );
+   BOOST_CHECK_EQUAL( stats.totalHeightGain, route.totalHeightGain() );
+   BOOST_CHECK_EQUAL( stats.netHeightGain, route.netHeightGain() );
+   BOOST_CHECK_EQUAL( stats.maxGradient, route.maxGradient() );
+   BOOST_CHECK_EQUAL( stats.minGradient, route.minGradient() );
+   BOOST_CHECK_EQUAL( stats.steepestGradient, route.steepestGradient() );
+   BOOST_CHECK_EQUAL( stats.minLatitude, route.minLatitude() );
+   BOOST_CHECK_EQUAL( stats.maxLatitude, route.maxLatitude() );
+   BOOST_CHECK_EQUAL( stats.minLongitude, route.minLongitude() );
+   BOOST_CHECK_EQUAL( stats.maxLongitude, route.maxLongitude() );
+   BOOST_CHECK_EQUAL( stats.minElevation, route.minElevation() );
+   BOOST_CHECK_EQUAL( stats.maxElevation, route.maxElevation() );
+
+   BOOST_CHECK_EQUAL( snapshot->route().name(), route.name() );
+   const std::string name = route.findNameOf(route[3]);
+   BOOST_CHECK_EQUAL( snapshot->route().findPosition(name).latitude(), route.findPosition(name).latitude() );
+}
+
+BOOST_AUTO_TEST_CASE( updatesLeaveTheOriginalUnchanged )
+{
+   const Route route(LogFiles::GPXRoutesDir + "ABCD.gpx", isFileName);
+   const std::shared_ptr<const RouteSnapshot> original = RouteSnapshot::of(route);
+   const unsigned int numPositions = original->statistics().numPositions;
+   const Position last = original->route()[numPositions - 1];
+   const Position far(last.latitude() + 0.1, last.longitude(), last.elevation() + 100);
+
+   const std::shared_ptr<const RouteSnapshot> appended = original->withPosition(far, "Far");
+   BOOST_CHECK_EQUAL( appended->statistics().numPositions, numPositions + 1 );
+   BOOST_CHECK( appended->statistics().totalLength > original->statistics().totalLength );
+   BOOST_CHECK_EQUAL( appended->route().findPosition("Far").latitude(), far.latitude() );
+   BOOST_CHECK_EQUAL( original->statistics().numPositions, numPositions );
+   BOOST_CHECK_THROW( original->route().findPosition("Far"), std::out_of_range );
+
+   // Too close to the last point to be kept.
+   BOOST_CHECK_EQUAL( original->withPosition(last, "Same")->statistics().numPositions, numPositions );
+
+   // Coarse enough to merge every point.
+   const std::shared_ptr<const RouteSnapshot> coarse = appended->withGranularity(1000000);
+   BOOST_CHECK_EQUAL( coarse->statistics().numPositions, 1 );
+   BOOST_CHECK_EQUAL( appended->statistics().numPositions, numPositions + 1 );
+}
+
+BOOST_AUTO_TEST_CASE( emptyRoutesAndNullSnapshots )
+{
+   const Route empty(std::vector<Position>{});
+   BOOST_CHECK_THROW( RouteSnapshot::of(empty), std::domain_error );
+   BOOST_CHECK_THROW( SharedRoute(nullptr), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( concurrentReadersSeeWholeSnapshots )
+{
+   const Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   SharedRoute shared(RouteSnapshot::of(track));
+   const unsigned int initialPositions = shared.snapshot()->statistics().numPositions;
+   const Position start = shared.snapshot()->route()[0];
+
+   const unsigned int numAppends = 200;
+   std::atomic<bool> finished {false};
+   std::atomic<unsigned int> inconsistencies {0};
+
+   auto reader = [&] ()
+   {
+      unsigned int previousPositions = 0;
+      while (! finished)
+      {
+         const std::shared_ptr<const RouteSnapshot> snapshot = shared.snapshot();
+         const RouteSnapshot::Statistics & stats = snapshot->statistics();
+         // The cached statistics always describe the snapshot's own points, and snapshots only grow.
+         if (stats.numPositions != snapshot->route().numPositions()) ++inconsistencies;
+         if (stats.maxLatitude != snapshot->route().maxLatitude()) ++inconsistencies;
+         if (stats.numPositions < previousPositions) ++inconsistencies;
+         previousPositions = stats.numPositions;
+      }
+   };
+
+   std::vector<std::thread> readers;
+   for (int t = 0; t < 3; ++t) readers.emplace_back(reader);
+   for (unsigned int i = 1; i <= numAppends; ++i)
+   {
+      shared.append(Position(start.latitude() + 0.01 * i, start.longitude(), start.elevation()));
+   }
+   finished = true;
+   for (std::thread & thread : readers) thread.join();
+
+   BOOST_CHECK_EQUAL( inconsistencies, 0 );
+   BOOST_CHECK_EQUAL( shared.snapshot()->statistics().numPositions, initialPositions + numAppends );
+
+   shared.setGranularity(1000000);
+   BOOST_CHECK_EQUAL( shared.snapshot()->statistics().numPositions, 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
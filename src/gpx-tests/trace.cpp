@@ -0,0 +1,127 @@
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logs.h"
+#include "types.h"
+#include "track.h"
+#include "trace.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( TraceSpans )
+
+const bool isFileName = true;
+
+std::string traceJSON()
+{
+   std::ostringstream json;
+   Trace::writeJSON(json);
+   return json.str();
+}
+
+bool contains(const std::string & str, const std::string & sought)
+{
+   return str.find(sought) != std::string::npos;
+}
+
+BOOST_AUTO_TEST_CASE( nothingRecordedWhenDisabled )
+{
+   Trace::clear();
+   Trace::enable(false);
+   Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   track.maxSpeed();
+
+   BOOST_CHECK( ! Trace::enabled() );
+   BOOST_CHECK_EQUAL( Trace::numEvents(), 0 );
+   BOOST_CHECK_EQUAL( traceJSON(), "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n]}\n" );
+}
+
+BOOST_AUTO_TEST_CASE( loadAndStatisticPhases )
+{
+   BOOST_REQUIRE( Trace::compiledIn );
+
+   Trace::clear();
+   Trace::enable();
+   Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   track.maxSpeed();
+   track.maxElevation();
+   Trace::enable(false);
+
+   const std::string json = traceJSON();
+   BOOST_CHECK( contains(json, "\"name\": \"Route::readFileData\"") );
+   BOOST_CHECK( contains(json, "\"name\": \"Route::setupFileData\"") );
+   BOOST_CHECK( contains(json, "\"name\": \"Track::pointLoop\"") );
+   BOOST_CHECK( contains(json, "\"name\": \"Route::setRouteLength\"") );
+   BOOST_CHECK( contains(json, "\"name\": \"Track::maxSpeed\"") );
+   BOOST_CHECK( contains(json, "\"name\": \"Route::maxElevation\"") );
+   BOOST_CHECK( contains(json, "\"ph\": \"X\"") );
+   BOOST_CHECK_EQUAL( Trace::numEvents(), 6 );
+
+   // Spans after recording stopped are not recorded.
+   track.maxSpeed();
+   BOOST_CHECK_EQUAL( Trace::numEvents(), 6 );
+
+   Trace::clear();
+   BOOST_CHECK_EQUAL( Trace::numEvents(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( manySpans )
+{
+   BOOST_REQUIRE( Trace::compiledIn );
+
+   // More than fit in a single buffer chunk.
+   const std::size_t numSpans = 10000;
+   Trace::clear();
+   Trace::enable();
+   for (std::size_t i = 0; i < numSpans; ++i)
+   {
+      Trace::Span span("manySpans");
+   }
+   Trace::enable(false);
+
+   BOOST_CHECK_EQUAL( Trace::numEvents(), numSpans );
+   const std::string json = traceJSON();
+   std::size_t count = 0;
+   for (std::size_t pos = json.find("manySpans"); pos != std::string::npos; pos = json.find("manySpans", pos + 1)) ++count;
+   BOOST_CHECK_EQUAL( count, numSpans );
+   Trace::clear();
+}
+
+BOOST_AUTO_TEST_CASE( separateThreads )
+{
+   BOOST_REQUIRE( Trace::compiledIn );
+
+   Trace::clear();
+   Trace::enable();
+   {
+      Trace::Span span("mainThread");
+   }
+   std::vector<std::thread> threads;
+   for (int t = 0; t < 3; ++t)
+   {
+      threads.emplace_back([] { Trace::Span span("workerThread"); });
+   }
+   for (std::thread & thread : threads) thread.join();
+   Trace::enable(false);
+
+   // Buffers outlive their threads.
+   BOOST_CHECK_EQUAL( Trace::numEvents(), 4 );
+
+   const std::string json = traceJSON();
+   std::set<std::string> tids;
+   const std::string tidKey = "\"tid\": ";
+   for (std::size_t pos = json.find(tidKey); pos != std::string::npos; pos = json.find(tidKey, pos + 1))
+   {
+      const std::size_t start = pos + tidKey.length();
+      tids.insert(json.substr(start, json.find(',', start) - start));
+   }
+   BOOST_CHECK_EQUAL( tids.size(), 4 );
+   Trace::clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "types.h"
+#include "track.h"
+#include "workload.h"
+
+using namespace GPS;
+
+/* Workload corpora must be reproducible from their seed, independently of how many threads
+ * generate them, and must produce GPX that the Track parser accepts.
+ */
+
+BOOST_AUTO_TEST_SUITE( Workload_generator )
+
+Workload::Options smallFiles()
+{
+   Workload::Options options;
+   options.seed = 42;
+   options.fileSize = 20000;
+   options.gridSize = 21;
+   return options;
+}
+
+std::string contentsOf(const std::string & path)
+{
+   std::ifstream file(path);
+   std::ostringstream contents;
+   contents << file.rdbuf();
+   return contents.str();
+}
+
+BOOST_AUTO_TEST_CASE( sameSeedSameTrack )
+{
+   const Workload::Options options = smallFiles();
+   Workload::Options otherSeed = options;
+   otherSeed.seed = 43;
+
+   BOOST_CHECK_EQUAL( Workload::trackStringFor(options, 3), Workload::trackStringFor(options, 3) );
+   BOOST_CHECK( Workload::trackStringFor(options, 3) != Workload::trackStringFor(options, 4) );
+   BOOST_CHECK( Workload::trackStringFor(options, 3) != Workload::trackStringFor(otherSeed, 3) );
+   BOOST_CHECK( Workload::trackFor(options, 3).toNMEA(10) == Workload::trackFor(options, 3).toNMEA(10) );
+}
+
+BOOST_AUTO_TEST_CASE( walksIncludeRestsAndDuplicates )
+{
+   Workload::Options options = smallFiles();
+   BOOST_CHECK( GridWorldTrack::isValidTrackString(Workload::trackStringFor(options, 0)) );
+
+   // Every step a rest: the walk never leaves the central point, but time passes.
+   options.restProbability = 1;
+   options.duplicateProbability = 0;
+   const std::string rests = Workload::trackStringFor(options, 0);
+   BOOST_CHECK_EQUAL( rests.substr(0, 7), "(10,10)" );
+   BOOST_CHECK( rests.find_first_of("ABCDEFGHIJKLMNOPQRSTUVWXY") == std::string::npos );
+   BOOST_CHECK( rests.find("(10,10)0") == std::string::npos );
+   BOOST_CHECK_EQUAL( GridWorldTrack::routeStringFromTrackString(rests).find_first_not_of("(10,)"), std::string::npos );
+
+   // Every step a duplicate: the same point, logged again at the same time.
+   options.restProbability = 0;
+   options.duplicateProbability = 1;
+   const std::string duplicates = Workload::trackStringFor(options, 0);
+   std::string expected = "(10,10)";
+   while (expected.length() < duplicates.length()) expected += "0(10,10)";
+   BOOST_CHECK_EQUAL( duplicates, expected );
+}
+
+BOOST_AUTO_TEST_CASE( corpusIsIndependentOfThreadCount )
+{
+   const Workload::Options options = smallFiles();
+   const std::size_t numFiles = 6;
+
+   char directory[] = "/tmp/workloadXXXXXX";
+   BOOST_REQUIRE( ::mkdtemp(directory) != nullptr );
+
+   const std::vector<std::string> paths = Workload::generateCorpus(options, directory, numFiles * options.fileSize, 4);
+   BOOST_REQUIRE_EQUAL( paths.size(), numFiles );
+
+   for (std::size_t index = 0; index < numFiles; ++index)
+   {
+       const std::string gpx = contentsOf(paths[index]);
+       std::string expected;
+       Workload::trackFor(options, index).toGPX(XML::Generator::stringSink(expected), options.logInterval);
+       BOOST_CHECK( gpx == expected );
+       BOOST_CHECK( gpx.length() > options.fileSize / 2 && gpx.length() < options.fileSize * 2 );
+   }
+
+   // The Track parser accepts the output, and the walk crosses the antimeridian.
+   const bool isFileName = true;
+   Track track(paths[0], isFileName, 0);
+   BOOST_CHECK( track.numPositions() > 100 );
+   BOOST_CHECK( track.minLongitude() < 0 );
+   BOOST_CHECK( track.maxLongitude() > 0 );
+
+   for (const std::string & path : paths) std::remove(path.c_str());
+   ::rmdir(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "types.h"
+#include "route.h"
+#include "track.h"
+#include "allocationcounter.h"
+
+using namespace GPS;
+
+/* Statistics queries on constructed Routes and Tracks should never allocate.
+ * Each query is run once beforehand, so that any one-off work (e.g. filling a cache)
+ * is not counted.
+ */
+
+BOOST_AUTO_TEST_SUITE( ZeroAllocationQueries )
+
+const bool isFileName = true;
+
+void checkNoAllocations(const std::string & query, std::function<void()> run)
+{
+   run();
+   AllocationCounter counter;
+   run();
+   BOOST_CHECK_MESSAGE( counter.allocations() == 0, query << " made " << counter.allocations() << " allocations" );
+}
+
+void checkRouteQueries(const Route & route)
+{
+   BOOST_REQUIRE( route.numPositions() > 1 );
+   const Position somewhere = route[route.numPositions() / 2];
+   const std::string name = route.findNameOf(somewhere);
+   double sink = 0;
+
+   checkNoAllocations("numPositions", [&] { sink += route.numPositions(); });
+   checkNoAllocations("totalLength", [&] { sink += route.totalLength(); });
+   checkNoAllocations("netLength", [&] { sink += route.netLength(); });
+   checkNoAllocations("totalHeightGain", [&] { sink += route.totalHeightGain(); });
+   checkNoAllocations("netHeightGain", [&] { sink += route.netHeightGain(); });
+   checkNoAllocations("maxGradient", [&] { sink += route.maxGradient(); });
+   checkNoAllocations("minGradient", [&] { sink += route.minGradient(); });
+   checkNoAllocations("steepestGradient", [&] { sink += route.steepestGradient(); });
+   checkNoAllocations("minLatitude", [&] { sink += route.minLatitude(); });
+   checkNoAllocations("maxLatitude", [&] { sink += route.maxLatitude(); });
+   checkNoAllocations("minLongitude", [&] { sink += route.minLongitude(); });
+   checkNoAllocations("maxLongitude", [&] { sink += route.maxLongitude(); });
+   checkNoAllocations("minElevation", [&] { sink += route.minElevation(); });
+   checkNoAllocations("maxElevation", [&] { sink += route.maxElevation(); });
+   checkNoAllocations("operator[]", [&] { sink += route[1].latitude(); });
+   checkNoAllocations("findPosition", [&] { sink += route.findPosition(name).latitude(); });
+   checkNoAllocations("timesVisited(Position)", [&] { sink += route.timesVisited(somewhere); });
+   checkNoAllocations("timesVisited(name)", [&] { sink += route.timesVisited(name); });
+   checkNoAllocations("timesVisited(unknown name)", [&] { sink += route.timesVisited("No such point"); });
+   checkNoAllocations("memoryUsage", [&] { sink += route.memoryUsage().total(); });
+   checkNoAllocations("loadStats", [&] { sink += route.loadStats().pointsSeen; });
+
+   BOOST_CHECK( sink == sink ); // Keeps the queries from being optimised away.
+}
+
+BOOST_AUTO_TEST_CASE( routeQueries )
+{
+   checkRouteQueries(Route(LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx", isFileName));
+   checkRouteQueries(Route(LogFiles::GPXRoutesDir + "ABCDEFGHIJKLMNOPQRSTUVWXY.gpx", isFileName));
+}
+
+BOOST_AUTO_TEST_CASE( trackQueries )
+{
+   const Track track(LogFiles::GPXTracksDir + "A1B3C.gpx", isFileName);
+   checkRouteQueries(track);
+
+   double sink = 0;
+   checkNoAllocations("totalTime", [&] { sink += track.totalTime(); });
+   checkNoAllocations("restingTime", [&] { sink += track.restingTime(); });
+   checkNoAllocations("travellingTime", [&] { sink += track.travellingTime(); });
+   checkNoAllocations("maxSpeed", [&] { sink += track.maxSpeed(); });
+   checkNoAllocations("averageSpeed", [&] { sink += track.averageSpeed(true) + track.averageSpeed(false); });
+   checkNoAllocations("maxRateOfAscent", [&] { sink += track.maxRateOfAscent(); });
+   checkNoAllocations("maxRateOfDescent", [&] { sink += track.maxRateOfDescent(); });
+   BOOST_CHECK( sink == sink );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
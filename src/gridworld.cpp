@@ -1,5 +1,8 @@
 #include <sstream>
+#include <algorithm>
+#include <charconv>
 #include <cassert>
+#include <cctype>
 #include <cmath>
 #include <stdexcept>
 
@@ -12,6 +15,27 @@ using namespace GPS;
 const int GridWorld::gridSize = 5;
 
 GridWorld::GridWorld(const Position & posM, metres horizontalGridUnit, metres verticalGridUnit)
+  : GridWorld(gridSize, gridSize, posM, horizontalGridUnit, verticalGridUnit)
+{}
+
+GridWorld::GridWorld(unsigned int rows, unsigned int columns, const Position & posCentre,
+                     metres horizontalGridUnit, metres verticalGridUnit)
+  : GridWorld(AngularUnits{}, posCentre,
+              Earth::latitudeSubtendedBy(horizontalGridUnit),
+              Earth::longitudeSubtendedBy(horizontalGridUnit,posCentre.latitude()),
+              verticalGridUnit, rows, columns)
+{}
+
+GridWorld GridWorld::fromAngularUnits(const Position & posCentre, degrees latitudeGridUnit, degrees longitudeGridUnit,
+                                      metres verticalGridUnit, unsigned int rows, unsigned int columns)
+{
+    return GridWorld(AngularUnits{}, posCentre, latitudeGridUnit, longitudeGridUnit, verticalGridUnit, rows, columns);
+}
+
+GridWorld::GridWorld(AngularUnits, const Position & posCentre, degrees deltaLat, degrees deltaLon, metres verticalGridUnit,
+                     unsigned int rows, unsigned int columns)
+  : numRows{rows},
+    numColumns{columns}
 {
     /* A B C D E
      * F G H I J
@@ -20,45 +44,153 @@ GridWorld::GridWorld(const Position & posM, metres horizontalGridUnit, metres ve
      * U V W X Y
      */
 
-    degrees deltaLat = Earth::latitudeSubtendedBy(horizontalGridUnit);
-    degrees deltaLon = Earth::longitudeSubtendedBy(horizontalGridUnit,posM.latitude());
+    if (rows == 0 || columns == 0) throw std::invalid_argument("A GridWorld must have at least one row and column.");
+
+    const unsigned int centreRow = rows / 2;
+    const unsigned int centreColumn = columns / 2;
+
+    grid.reserve(static_cast<std::size_t>(rows) * columns);
 
-    GridWorld::Point currentPoint = 'A';
-    degrees lat = posM.latitude() + 2*deltaLat;
-    for (int i = 0; i < gridSize; ++i)
+    degrees lat = posCentre.latitude() + centreRow*deltaLat;
+    for (unsigned int i = 0; i < rows; ++i)
     {
-        degrees lon = posM.longitude() - 2*deltaLon;
-        for (int j = 0; j < gridSize; ++j)
+        degrees lon = posCentre.longitude() - centreColumn*deltaLon;
+        unsigned int rowSteps = (i > centreRow) ? i - centreRow : centreRow - i;
+        for (unsigned int j = 0; j < columns; ++j)
         {
-            metres ele = calcElevationFor(currentPoint, posM.elevation(), verticalGridUnit);
+            unsigned int columnSteps = (j > centreColumn) ? j - centreColumn : centreColumn - j;
+            metres ele = calcElevationFor(std::max(rowSteps,columnSteps), posCentre.elevation(), verticalGridUnit);
             std::pair<degrees,degrees> normLatLon = normaliseLatLon(lat,lon);
-            grid.insert({currentPoint,Position(normLatLon.first,normLatLon.second,ele)});
+            grid.push_back(Position(normLatLon.first,normLatLon.second,ele));
             lon += deltaLon;
-            ++currentPoint;
         }
         lat -= deltaLat;
     }
 }
 
+unsigned int GridWorld::rows() const
+{
+    return numRows;
+}
+
+unsigned int GridWorld::columns() const
+{
+    return numColumns;
+}
+
+bool GridWorld::isStandardGrid() const
+{
+    return numRows == static_cast<unsigned int>(gridSize) && numColumns == static_cast<unsigned int>(gridSize);
+}
+
 const Position& GridWorld::operator[](Point point) const
 {
-    return grid.at(point);
+    const unsigned int index = static_cast<unsigned int>(point - 'A');
+    if (point < 'A' || index >= grid.size() || ! isStandardGrid())
+        throw std::out_of_range(std::string("'") + point + "' is not a GridWorld point.");
+    return grid[index];
+}
+
+bool GridWorld::contains(Coordinates coords) const
+{
+    return coords.row < numRows && coords.column < numColumns;
+}
+
+const Position& GridWorld::operator[](Coordinates coords) const
+{
+    if (! contains(coords))
+        throw std::out_of_range("(" + std::to_string(coords.row) + "," + std::to_string(coords.column) + ") is outside the GridWorld.");
+    return grid[static_cast<std::size_t>(coords.row) * numColumns + coords.column];
+}
+
+void GridWorld::setElevation(Coordinates coords, metres ele)
+{
+    const Position & pos = (*this)[coords];
+    grid[static_cast<std::size_t>(coords.row) * numColumns + coords.column] = Position(pos.latitude(), pos.longitude(), ele);
+}
+
+GridWorld::Coordinates GridWorld::coordinatesOf(Point point)
+{
+    const unsigned int index = static_cast<unsigned int>(point - 'A');
+    return {index / gridSize, index % gridSize};
+}
+
+bool GridWorld::readPoint(const std::string & str, std::size_t & pos, Coordinates & coords)
+{
+    if (pos >= str.length()) return false;
+
+    if (str[pos] >= 'A' && str[pos] <= 'Y')
+    {
+        coords = coordinatesOf(str[pos]);
+        ++pos;
+        return true;
+    }
+
+    if (str[pos] != '(') return false;
+
+    // Reads a non-empty run of digits starting at "i".
+    auto readNumber = [&str] (std::size_t & i, unsigned int & value)
+    {
+        std::size_t begin = i;
+        unsigned long long number = 0;
+        while (i < str.length() && std::isdigit(static_cast<unsigned char>(str[i])) && number <= 0xFFFFFFFFULL)
+        {
+            number = number * 10 + static_cast<unsigned int>(str[i] - '0');
+            ++i;
+        }
+        value = static_cast<unsigned int>(number);
+        return i > begin && number <= 0xFFFFFFFFULL;
+    };
+
+    std::size_t i = pos + 1;
+    Coordinates read;
+    if (! readNumber(i, read.row) || i >= str.length() || str[i] != ',') return false;
+    ++i;
+    if (! readNumber(i, read.column) || i >= str.length() || str[i] != ')') return false;
+
+    coords = read;
+    pos = i + 1;
+    return true;
+}
+
+std::string GridWorld::nameOf(Coordinates coords) const
+{
+    char name[maxNameLength];
+    return std::string(name, formatName(name, coords));
+}
+
+char * GridWorld::formatName(char * buffer, Coordinates coords) const
+{
+    if (isStandardGrid())
+    {
+        *buffer = static_cast<char>('A' + coords.row * gridSize + coords.column);
+        return buffer + 1;
+    }
+
+    char * const end = buffer + maxNameLength;
+    char * out = buffer;
+    *out++ = '(';
+    out = std::to_chars(out, end, coords.row).ptr;
+    *out++ = ',';
+    out = std::to_chars(out, end, coords.column).ptr;
+    *out++ = ')';
+    return out;
 }
 
-metres GridWorld::calcElevationFor(Point point, metres eleM, metres verticalGridUnit)
+metres GridWorld::calcElevationFor(unsigned int stepsFromCentre, metres eleCentre, metres verticalGridUnit)
 {
-    /* "eleM" is the elevation of Point M.
-     * Neighbours of M are 1 vertical grid unit lower than M.
-     * All other Points are 2 vertical grid units lower than M.
+    /* "eleCentre" is the elevation of the central point (M in the 5x5 grid).
+     * Neighbours of the centre (G H I L N Q R S) are 1 vertical grid unit lower.
+     * All other Points are 2 vertical grid units lower.
      */
-    switch (point)
+    switch (stepsFromCentre)
     {
-        case 'M':
-            return eleM;
-        case 'G': case 'H': case 'I': case 'L': case 'N': case 'Q': case 'R': case 'S':
-            return eleM - verticalGridUnit;
+        case 0:
+            return eleCentre;
+        case 1:
+            return eleCentre - verticalGridUnit;
         default:
-            return eleM - (2 * verticalGridUnit);
+            return eleCentre - (2 * verticalGridUnit);
     }
 }
 
@@ -3,6 +3,7 @@
 #include <cctype>
 
 #include "xmlgenerator.h"
+#include "nmeagenerator.h"
 #include "gridworld_route.h"
 
 using namespace GPS;
@@ -13,6 +14,16 @@ GridWorldRoute::GridWorldRoute(std::string routeStr, GridWorld gridworld)
 {
     if (! isValidRouteString(routeStr))
         throw std::invalid_argument("Invalid point sequence, cannot construct Route.");
+
+    GridWorld::Coordinates coords;
+    for (std::size_t pos = 0, pointBegin = 0; GridWorld::readPoint(routeString, pos, coords); pointBegin = pos)
+    {
+        if (routeString[pointBegin] != '(' && ! gridworld.isStandardGrid())
+            throw std::invalid_argument("Route refers to an A-Y point, but the GridWorld is not 5x5, cannot construct Route.");
+        if (! gridworld.contains(coords))
+            throw std::invalid_argument("Route refers to a point outside the GridWorld, cannot construct Route.");
+        waypoints.push_back(coords);
+    }
 }
 
 std::string GridWorldRoute::toGPX(bool embedName, const std::string& routeName) const
@@ -30,18 +41,47 @@ std::string GridWorldRoute::toGPX(bool embedName, const std::string& routeName)
     }
 
     const bool includeElevation = false; // For Position interface
-    for (GridWorld::Point point : routeString)
+    char attributes[Position::maxFormattedLength];
+    char name[GridWorld::maxNameLength];
+    for (GridWorld::Coordinates point : waypoints)
     {
         const Position& pos = gridworld[point];
-        gpx.openElement("rtept", pos.toString(includeElevation));
-        gpx.element("name","",std::string(1,point));
-        gpx.element("ele", "",std::to_string(pos.elevation()));
+        gpx.openElement("rtept", std::string_view(attributes, pos.formatTo(attributes, includeElevation) - attributes));
+        gpx.element("name","",std::string_view(name, gridworld.formatName(name, point) - name));
+        gpx.element("ele", "",pos.elevation());
         gpx.closeElement(); // "rtept"
     }
 
     return gpx.closeAllElementsAndExtractString();
 }
 
+Route GridWorldRoute::toRoute(metres granularity, const std::string& routeName) const
+{
+    std::vector<Position> positions;
+    std::vector<std::string> names;
+    positions.reserve(waypoints.size());
+    names.reserve(waypoints.size());
+    for (GridWorld::Coordinates point : waypoints)
+    {
+        positions.push_back(gridworld[point]);
+        names.push_back(gridworld.nameOf(point));
+    }
+    return Route(positions, names, routeName.empty() ? routeString : routeName, granularity);
+}
+
+std::string GridWorldRoute::toNMEA() const
+{
+    // Routes carry no timing information, so each point is a GGA sentence with an empty time field.
+    std::string nmea(waypoints.size() * NMEA::Generator::maxSentenceLength, '\0');
+    std::size_t length = 0;
+    for (GridWorld::Coordinates point : waypoints)
+    {
+        length += NMEA::Generator::writeGGA(&nmea[length], gridworld[point]);
+    }
+    nmea.resize(length);
+    return nmea;
+}
+
 std::string GridWorldRoute::toString() const
 {
     return routeString;
@@ -49,7 +89,9 @@ std::string GridWorldRoute::toString() const
 
 bool GridWorldRoute::isValidRouteString(const std::string & routeStr)
 {
-    // To be valid, all chars must be in the range 'A'..'Y'.
-    return std::all_of(routeStr.begin(), routeStr.end(),
-                       [] (char point)->bool {return point >= 'A' && point <= 'Y';});
+    // To be valid, the string must consist entirely of point references: chars in the range 'A'..'Y', or "(row,column)".
+    GridWorld::Coordinates coords;
+    std::size_t pos = 0;
+    while (GridWorld::readPoint(routeStr, pos, coords)) {}
+    return pos == routeStr.length();
 }
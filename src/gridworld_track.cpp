@@ -3,9 +3,15 @@
 #include <cctype>
 #include <cassert>
 #include <sstream>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <unistd.h>
 
 #include "geometry.h"
 #include "xmlgenerator.h"
+#include "nmeagenerator.h"
 #include "gridworld_route.h"
 #include "gridworld_track.h"
 
@@ -21,60 +27,81 @@ GridWorldTrack::GridWorldTrack(std::string trackStr, seconds timeUnitDur, second
     constructWaypoints();
 }
 
-void GridWorldTrack::constructWaypoints()
+namespace
 {
-    std::istringstream tss(trackString);
+    struct ParsedTrack
+    {
+        std::vector<GridWorld::Coordinates> waypoints;
+        std::vector<unsigned int> timeUnitsToNextWaypoint;
+        std::string routeString;
+        bool hasLetterPoints = false; // Any A-Y references, rather than "(row,column)".
+    };
 
-    GridWorld::Point point;
-    unsigned int timeUnits;
-    while (tss >> point)
+    /* A track string is a sequence of point references (see GridWorld::readPoint), each pair
+     * separated by an optional number of time units (0 if omitted).
+     * Returns false if the track string is ill-formed.
+     */
+    bool parseTrackString(const std::string & trackStr, ParsedTrack & parsed)
     {
-        waypoints.push_back(point);
-        tss >> timeUnits;
-        timeUnitsToNextWaypoint.push_back(timeUnits);
-    }
-    timeUnitsToNextWaypoint.pop_back(); // Discard any time units after the final waypoint.
+        std::size_t pos = 0;
+        while (pos < trackStr.length())
+        {
+            const std::size_t pointBegin = pos;
+            GridWorld::Coordinates coords;
+            if (! GridWorld::readPoint(trackStr, pos, coords)) return false;
+            if (trackStr[pointBegin] != '(') parsed.hasLetterPoints = true;
+            parsed.waypoints.push_back(coords);
+            parsed.routeString.append(trackStr, pointBegin, pos - pointBegin);
 
-    assert(waypoints.size() == (timeUnitsToNextWaypoint.size() + 1));
+            if (pos == trackStr.length()) break;
+
+            unsigned long long timeUnits = 0;
+            while (pos < trackStr.length() && std::isdigit(static_cast<unsigned char>(trackStr[pos])))
+            {
+                timeUnits = timeUnits * 10 + static_cast<unsigned int>(trackStr[pos] - '0');
+                if (timeUnits > 0xFFFFFFFFULL) return false;
+                ++pos;
+            }
+            if (pos == trackStr.length()) return false; // No trailing time after the final waypoint.
+            parsed.timeUnitsToNextWaypoint.push_back(static_cast<unsigned int>(timeUnits));
+        }
+        return true;
+    }
 }
 
-std::string GridWorldTrack::toGPX(seconds logInterval, bool embedName, const std::string& trackName) const
+void GridWorldTrack::constructWaypoints()
 {
-    XML::Generator gpx;
+    ParsedTrack parsed;
+    parseTrackString(trackString, parsed);
 
-    gpx.basicXMLDeclaration();
-    gpx.openBasicGPXElement();
+    if (parsed.hasLetterPoints && ! gridworld.isStandardGrid())
+        throw std::invalid_argument("Track refers to an A-Y point, but the GridWorld is not 5x5, cannot construct Track.");
 
-    gpx.openElement("trk","");
-    if (embedName)
+    for (GridWorld::Coordinates coords : parsed.waypoints)
     {
-        std::string name = trackName.empty() ? trackString : trackName;
-        gpx.element("name", "", name);
+        if (! gridworld.contains(coords))
+            throw std::invalid_argument("Track refers to a point outside the GridWorld, cannot construct Track.");
     }
 
-    const bool includeElevation = false; // For Position interface
-
-    std::vector<unsigned int>::const_iterator timeUnitsIt = timeUnitsToNextWaypoint.begin();
-    std::vector<GridWorld::Point>::const_iterator pointsIt = waypoints.begin();
+    waypoints = std::move(parsed.waypoints);
+    timeUnitsToNextWaypoint = std::move(parsed.timeUnitsToNextWaypoint);
 
-    seconds segmentStartTime = startTime;
+    assert(waypoints.empty() || waypoints.size() == (timeUnitsToNextWaypoint.size() + 1));
+}
 
-    GridWorld::Point currentPoint = *pointsIt;
-    ++pointsIt;
-    for (; pointsIt != waypoints.end(); ++pointsIt, ++timeUnitsIt)
+namespace
+{
+    /* Calls visit(position,time) for each logged point along the segment from "currentPos" to "nextPos",
+     * including both endpoints.
+     */
+    template <typename PointVisitor>
+    void interpolateSegment(const Position& currentPos, const Position& nextPos,
+                            seconds segmentStartTime, seconds timeThisSegment, seconds logInterval,
+                            PointVisitor visit)
     {
-        GridWorld::Point nextPoint = *pointsIt;
-        gpx.openElement("trkseg","");
-
-        const std::string segmentName = std::string(1,currentPoint) + "-" + std::string(1,nextPoint);
-        gpx.element("name","",segmentName);
-
-        seconds timeThisSegment = (*timeUnitsIt) * timeUnitDuration;
         seconds segmentEndTime = segmentStartTime + timeThisSegment;
         double stepsThisSegment = timeThisSegment / logInterval;
 
-        const Position& currentPos = gridworld[currentPoint];
-        const Position& nextPos = gridworld[nextPoint];
         degrees deltaLat = (nextPos.latitude() - currentPos.latitude()) / stepsThisSegment;
         degrees deltaLon = normaliseDeg(nextPos.longitude() - currentPos.longitude()) / stepsThisSegment; // Normalise longitude difference to ensure we don't take the long way around
         metres deltaEle = (nextPos.elevation() - currentPos.elevation()) / stepsThisSegment;
@@ -86,25 +113,220 @@ std::string GridWorldTrack::toGPX(seconds logInterval, bool embedName, const std
         {
             // Mathematically we shouldn't need to normalise the latitude; however we do so to catch any floating-point rounding errors.
             std::pair<degrees,degrees> normLatLon = normaliseLatLon(lat,lon);
-            Position pos = Position(normLatLon.first, normLatLon.second, ele);
-            gpx.openElement("trkpt", pos.toString(includeElevation));
-            gpx.element("ele", "",std::to_string(pos.elevation()));
-            gpx.element("time","",std::to_string(currentTime));
-            gpx.closeElement(); // "trkpt"
+            visit(Position(normLatLon.first, normLatLon.second, ele), currentTime);
 
             lat += deltaLat;
             lon += deltaLon;
             ele += deltaEle;
         }
+    }
+}
 
-        segmentStartTime = segmentEndTime;
-        gpx.closeElement(); // "trkseg"
+std::string GridWorldTrack::toGPX(seconds logInterval, bool embedName, const std::string& trackName, bool compact,
+                                  unsigned int threads) const
+{
+    XML::Generator gpx(4, compact);
+    writeGPX(gpx, logInterval, embedName, trackName, threads);
+    return gpx.closeAllElementsAndExtractString();
+}
+
+void GridWorldTrack::toGPX(XML::Generator::Sink sink, seconds logInterval, bool embedName, const std::string& trackName, bool compact,
+                           unsigned int threads) const
+{
+    XML::Generator gpx(std::move(sink), 4, compact);
+    writeGPX(gpx, logInterval, embedName, trackName, threads);
+    gpx.closeAllElements();
+    gpx.flush();
+}
+
+void GridWorldTrack::writeGPX(XML::Generator& gpx, seconds logInterval, bool embedName, const std::string& trackName,
+                              unsigned int threads) const
+{
+    gpx.basicXMLDeclaration();
+    gpx.openBasicGPXElement();
+
+    gpx.openElement("trk","");
+    if (embedName)
+    {
+        std::string name = trackName.empty() ? trackString : trackName;
+        gpx.element("name", "", name);
+    }
 
-        currentPoint = nextPoint;
-        segmentStartTime = segmentEndTime;
+    if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+    if (threads > 1)
+    {
+        writeSegmentsInParallel(gpx, logInterval, threads);
+        return;
     }
 
-    return gpx.closeAllElementsAndExtractString();
+    seconds segmentStartTime = startTime;
+    for (std::size_t i = 0; i < timeUnitsToNextWaypoint.size(); ++i)
+    {
+        writeSegment(gpx, i, segmentStartTime, logInterval);
+        segmentStartTime += timeUnitsToNextWaypoint[i] * timeUnitDuration;
+    }
+}
+
+void GridWorldTrack::writeSegment(XML::Generator& gpx, std::size_t segment, seconds segmentStartTime, seconds logInterval) const
+{
+    const bool includeElevation = false; // For Position interface
+    char attributes[Position::maxFormattedLength];
+
+    GridWorld::Coordinates currentPoint = waypoints[segment];
+    GridWorld::Coordinates nextPoint = waypoints[segment+1];
+    gpx.openElement("trkseg","");
+
+    char segmentName[2 * GridWorld::maxNameLength + 1];
+    char * segmentNameEnd = gridworld.formatName(segmentName, currentPoint);
+    *segmentNameEnd++ = '-';
+    segmentNameEnd = gridworld.formatName(segmentNameEnd, nextPoint);
+    gpx.element("name","",std::string_view(segmentName, segmentNameEnd - segmentName));
+
+    seconds timeThisSegment = timeUnitsToNextWaypoint[segment] * timeUnitDuration;
+    interpolateSegment(gridworld[currentPoint], gridworld[nextPoint], segmentStartTime, timeThisSegment, logInterval,
+                       [&] (const Position& pos, seconds currentTime)
+    {
+        gpx.openElement("trkpt", std::string_view(attributes, pos.formatTo(attributes, includeElevation) - attributes));
+        gpx.element("ele", "",pos.elevation());
+        gpx.element("time","",currentTime);
+        gpx.closeElement(); // "trkpt"
+    });
+
+    gpx.closeElement(); // "trkseg"
+}
+
+void GridWorldTrack::writeSegmentsInParallel(XML::Generator& gpx, seconds logInterval, unsigned int threads) const
+/* Each segment depends only on its endpoints and start time, so runs of consecutive segments
+ * are rendered into separate fragments concurrently, then inserted in order.
+ * The track is processed a window (one run per thread) at a time, so that memory use stays
+ * bounded when writing to a Sink.
+ */
+{
+    const std::size_t pointsPerRun = 1 << 14;
+    const std::size_t numSegments = timeUnitsToNextWaypoint.size();
+
+    std::size_t segment = 0;
+    seconds segmentStartTime = startTime;
+    while (segment < numSegments)
+    {
+        std::vector<std::future<std::string>> runs;
+        while (runs.size() < threads && segment < numSegments)
+        {
+            const std::size_t runBegin = segment;
+            const seconds runStartTime = segmentStartTime;
+            std::size_t points = 0;
+            while (segment < numSegments && points < pointsPerRun)
+            {
+                const seconds timeThisSegment = timeUnitsToNextWaypoint[segment] * timeUnitDuration;
+                points += timeThisSegment / logInterval + 1;
+                segmentStartTime += timeThisSegment;
+                ++segment;
+            }
+            const std::size_t runEnd = segment;
+
+            runs.push_back(std::async(std::launch::async, [this, &gpx, runBegin, runEnd, runStartTime, logInterval] ()
+            {
+                XML::Generator fragment = gpx.fragment(); // Only reads the layout, which insert() does not change.
+                seconds fragmentStartTime = runStartTime;
+                for (std::size_t i = runBegin; i < runEnd; ++i)
+                {
+                    writeSegment(fragment, i, fragmentStartTime, logInterval);
+                    fragmentStartTime += timeUnitsToNextWaypoint[i] * timeUnitDuration;
+                }
+                return fragment.closeAllElementsAndExtractString();
+            }));
+        }
+
+        for (std::future<std::string> & run : runs) gpx.insert(run.get());
+    }
+}
+
+template <typename PointVisitor>
+void GridWorldTrack::forEachPoint(seconds logInterval, PointVisitor visit) const
+{
+    seconds segmentStartTime = startTime;
+    for (std::size_t i = 1; i < waypoints.size(); ++i)
+    {
+        seconds timeThisSegment = timeUnitsToNextWaypoint[i-1] * timeUnitDuration;
+        interpolateSegment(gridworld[waypoints[i-1]], gridworld[waypoints[i]], segmentStartTime, timeThisSegment, logInterval, visit);
+        segmentStartTime += timeThisSegment;
+    }
+}
+
+template <typename SentenceVisitor>
+void GridWorldTrack::forEachNMEASentence(seconds logInterval, SentenceVisitor visit) const
+{
+    char sentence[NMEA::Generator::maxSentenceLength];
+
+    forEachPoint(logInterval, [&] (const Position& pos, seconds currentTime)
+    {
+        visit(sentence, NMEA::Generator::writeGGA(sentence, pos, currentTime));
+        visit(sentence, NMEA::Generator::writeRMC(sentence, pos, currentTime));
+        visit(sentence, NMEA::Generator::writeGLL(sentence, pos, currentTime));
+    });
+}
+
+Track GridWorldTrack::toTrack(seconds logInterval, metres granularity, const std::string& trackName) const
+{
+    std::vector<Position> positions;
+    std::vector<seconds> times;
+    forEachPoint(logInterval, [&] (const Position& pos, seconds currentTime)
+    {
+        positions.push_back(pos);
+        times.push_back(currentTime);
+    });
+    return Track(positions, times, trackName.empty() ? trackString : trackName, granularity);
+}
+
+std::string GridWorldTrack::toNMEA(seconds logInterval) const
+{
+    // Preallocate for the exact number of points' sentences, so the buffer never reallocates.
+    const std::size_t sentencesPerPoint = 3;
+    std::size_t numPoints = 0;
+    for (unsigned int timeUnits : timeUnitsToNextWaypoint)
+    {
+        numPoints += (timeUnits * timeUnitDuration) / logInterval + 1;
+    }
+
+    std::string nmea;
+    nmea.reserve(numPoints * sentencesPerPoint * NMEA::Generator::maxSentenceLength);
+    forEachNMEASentence(logInterval, [&nmea] (const char * sentence, std::size_t length)
+    {
+        nmea.append(sentence, length);
+    });
+    return nmea;
+}
+
+void GridWorldTrack::toNMEA(seconds logInterval, int fileDescriptor) const
+{
+    const std::size_t bufferSize = 1 << 16;
+    std::vector<char> buffer(bufferSize);
+    std::size_t used = 0;
+
+    auto flush = [&] ()
+    {
+        std::size_t written = 0;
+        while (written < used)
+        {
+            ssize_t result = ::write(fileDescriptor, buffer.data() + written, used - written);
+            if (result < 0)
+            {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("Error writing NMEA data to file descriptor.");
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        used = 0;
+    };
+
+    forEachNMEASentence(logInterval, [&] (const char * sentence, std::size_t length)
+    {
+        if (used + length > bufferSize) flush();
+        std::memcpy(buffer.data() + used, sentence, length);
+        used += length;
+    });
+    flush();
 }
 
 std::string GridWorldTrack::toString() const
@@ -114,16 +336,13 @@ std::string GridWorldTrack::toString() const
 
 bool GridWorldTrack::isValidTrackString(const std::string & trackStr)
 {
-    bool validChars = std::all_of(trackStr.begin(), trackStr.end(),
-                                  [] (char c) {return std::isupper(c) || std::isdigit(c);});
-    bool noLeadingOrTrailingTime = trackStr.length() == 0 || (isupper(trackStr.front()) && isupper(trackStr.back()));
-    return validChars && noLeadingOrTrailingTime && GridWorldRoute::isValidRouteString(routeStringFromTrackString(trackStr));
+    ParsedTrack parsed;
+    return parseTrackString(trackStr, parsed);
 }
 
 std::string GridWorldTrack::routeStringFromTrackString(const std::string & trackStr)
 {
-    std::string routeStr = trackStr;
-    routeStr.erase(std::remove_if(routeStr.begin(),routeStr.end(),[] (char c) {return std::isdigit(c);}),
-                   routeStr.end());
-    return routeStr;
+    ParsedTrack parsed;
+    parseTrackString(trackStr, parsed);
+    return parsed.routeString;
 }
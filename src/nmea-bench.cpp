@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+
+using namespace GPS;
+
+/* Benchmarks the NMEA ingest path on the bundled logs.
+ * Run from the "execs" directory, as with the test executables.
+ */
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  // The previous floating-point implementation of ddmTodd(), kept as a baseline.
+  degrees ddmToddViaStod(const std::string & ddmStr)
+  {
+      double ddm  = std::stod(ddmStr);
+      double degs = std::floor(ddm / 100);
+      double mins = ddm - 100 * degs;
+      return degs + mins / 60.0;
+  }
+
+  std::vector<std::string> ddmFieldsFromLog(const std::string & filepath)
+  {
+      std::vector<std::string> ddmFields;
+      std::ifstream file(filepath);
+      std::string line;
+      while (std::getline(file, line))
+      {
+          if (! isValidSentence(line)) continue;
+          NMEAPair sentence = decomposeSentence(line);
+          std::size_t latIndex = (sentence.first == "GPGGA") ? 1 : (sentence.first == "GPRMC") ? 2 : 0;
+          if (sentence.second.size() < latIndex + 3) continue;
+          ddmFields.push_back(sentence.second[latIndex]);
+          ddmFields.push_back(sentence.second[latIndex+2]);
+      }
+      return ddmFields;
+  }
+
+  template <typename Converter>
+  double nanosecondsPerConversion(const std::vector<std::string> & fields, unsigned int repetitions,
+                                  Converter convert, double & checksum)
+  {
+      Clock::time_point start = Clock::now();
+      for (unsigned int r = 0; r < repetitions; ++r)
+      {
+          for (const std::string & field : fields) checksum += convert(field);
+      }
+      std::chrono::duration<double,std::nano> elapsed = Clock::now() - start;
+      return elapsed.count() / (double(fields.size()) * repetitions);
+  }
+}
+
+int main()
+{
+    const std::string logFile = LogFiles::NMEALogsDir + "gga_rmc.log";
+    const unsigned int repetitions = 2000;
+
+    std::vector<std::string> fields = ddmFieldsFromLog(logFile);
+    if (fields.empty())
+    {
+        std::cerr << "No DDM fields read from '" << logFile << "'." << std::endl;
+        return 1;
+    }
+
+    double checksum = 0;
+    double stodNs  = nanosecondsPerConversion(fields, repetitions, ddmToddViaStod, checksum);
+    double fixedNs = nanosecondsPerConversion(fields, repetitions, ddmTodd, checksum);
+
+    double maxDifference = 0;
+    for (const std::string & field : fields)
+    {
+        maxDifference = std::max(maxDifference, std::abs(ddmTodd(field) - ddmToddViaStod(field)));
+    }
+
+    Clock::time_point start = Clock::now();
+    std::size_t positionsRead = 0;
+    for (unsigned int r = 0; r < 100; ++r) positionsRead += routeFromNMEALog(logFile).size();
+    std::chrono::duration<double,std::milli> logElapsed = Clock::now() - start;
+
+    std::cout << "DDM fields:              " << fields.size() << '\n'
+              << "ddmTodd via std::stod:   " << stodNs << " ns/field\n"
+              << "ddmTodd fixed-point:     " << fixedNs << " ns/field\n"
+              << "Max difference:          " << maxDifference << " degrees\n"
+              << "routeFromNMEALog:        " << logElapsed.count() / 100 << " ms/file ("
+              << positionsRead / 100 << " positions)\n"
+              << "(checksum " << checksum << ")" << std::endl;
+}
@@ -3,9 +3,18 @@
 #include <boost/test/unit_test.hpp>
 
 #include <stdexcept>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <unistd.h>
 
 #include "logs.h"
 #include "parseNMEA.h"
+#include "trace.h"
+#include "geometry.h"
+#include "gridworld_route.h"
+#include "gridworld_track.h"
 
 using namespace GPS;
 
@@ -272,6 +281,22 @@ BOOST_AUTO_TEST_CASE( UnsupportedFormat )
     BOOST_CHECK_THROW( extractPosition(decomposedSentence) , std::invalid_argument );
 }
 
+// Receivers also emit satellite and course sentences, which carry no position.
+BOOST_AUTO_TEST_CASE( OtherReceiverSentences )
+{
+    NMEAPair gsv = { "GPGSV", {"3","1","11","03","03","111","00","04","15","270","00","06","01","010","00","13","06","292","00"} };
+    BOOST_CHECK_THROW( extractPosition(gsv) , std::invalid_argument );
+
+    NMEAPair gsa = { "GPGSA", {"A","3","04","05","","09","12","","","24","","","","","2.5","1.3","2.1"} };
+    BOOST_CHECK_THROW( extractPosition(gsa) , std::invalid_argument );
+
+    NMEAPair vtg = { "GPVTG", {"054.7","T","034.4","M","005.5","N","010.2","K"} };
+    BOOST_CHECK_THROW( extractPosition(vtg) , std::invalid_argument );
+
+    NMEAPair truncated = { "GPGL", {"5425.31","N","107.03","W","82610"} };
+    BOOST_CHECK_THROW( extractPosition(truncated) , std::invalid_argument );
+}
+
 BOOST_AUTO_TEST_CASE( EmptyFieldVector )
 {
     NMEAPair decomposedSentenceGLL = { "GPGLL", {} };
@@ -395,6 +420,129 @@ BOOST_AUTO_TEST_CASE( AnnotatedLog_GGA_RMC )
 
 }
 
+BOOST_AUTO_TEST_CASE( TracedParsing )
+{
+    Trace::clear();
+    Trace::enable();
+    routeFromNMEALog(LogFiles::NMEALogsDir + "gll.log");
+    Trace::enable(false);
+
+    std::ostringstream json;
+    Trace::writeJSON(json);
+    BOOST_CHECK_EQUAL( Trace::numEvents() , Trace::compiledIn ? 1 : 0 );
+    if (Trace::compiledIn) BOOST_CHECK( json.str().find("\"routeFromNMEALog\"") != std::string::npos );
+    Trace::clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( GridWorldNMEA )
+
+// DDM minutes are generated to 4 decimal places.
+const double ddmAccuracy = 0.0001 / 60;
+
+std::vector<std::string> sentencesIn(const std::string & nmea)
+{
+    std::vector<std::string> sentences;
+    std::istringstream iss(nmea);
+    std::string line;
+    while (std::getline(iss, line)) sentences.push_back(line);
+    return sentences;
+}
+
+BOOST_AUTO_TEST_CASE( RouteSentences )
+{
+    const GridWorld gridworld(Earth::CityCampus, 1000, 10);
+    const std::string routeStr = "AGMSY";
+    std::vector<std::string> sentences = sentencesIn(GridWorldRoute(routeStr, gridworld).toNMEA());
+
+    BOOST_REQUIRE_EQUAL( sentences.size() , routeStr.length() );
+    for (unsigned int i = 0; i < sentences.size(); ++i)
+    {
+        BOOST_REQUIRE( isValidSentence(sentences[i]) );
+        Position pos = extractPosition(decomposeSentence(sentences[i]));
+        BOOST_CHECK_SMALL( pos.latitude() - gridworld[routeStr[i]].latitude() , ddmAccuracy );
+        BOOST_CHECK_SMALL( pos.longitude() - gridworld[routeStr[i]].longitude() , ddmAccuracy );
+        BOOST_CHECK_SMALL( pos.elevation() - gridworld[routeStr[i]].elevation() , 0.05 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( TrackSentences )
+{
+    // 1 unit from A to B, then 2 units from B to G, with 10s units and a 5s log interval.
+    const GridWorldTrack track("A1B2G", 10, 1410000000);
+    std::vector<std::string> sentences = sentencesIn(track.toNMEA(5));
+
+    // (3 + 5) points, each with a GGA, an RMC and a GLL sentence.
+    BOOST_REQUIRE_EQUAL( sentences.size() , 24 );
+    for (const std::string & sentence : sentences)
+    {
+        BOOST_CHECK( isValidSentence(sentence) );
+    }
+    BOOST_CHECK_EQUAL( decomposeSentence(sentences[0]).first , "GPGGA" );
+    BOOST_CHECK_EQUAL( decomposeSentence(sentences[1]).first , "GPRMC" );
+    BOOST_CHECK_EQUAL( decomposeSentence(sentences[2]).first , "GPGLL" );
+    BOOST_CHECK_EQUAL( decomposeSentence(sentences[2]).second[4] , "104000.000" );
+
+    // 1410000000 is 2014-09-06 10:40:00 UTC.
+    NMEAPair rmc = decomposeSentence(sentences[1]);
+    BOOST_CHECK_EQUAL( rmc.second[0] , "104000.000" );
+    BOOST_CHECK_EQUAL( rmc.second[8] , "060914" );
+
+    Position last = extractPosition(decomposeSentence(sentences.back()));
+    BOOST_CHECK_SMALL( last.latitude() - GridWorld()['G'].latitude() , ddmAccuracy );
+    BOOST_CHECK_SMALL( last.longitude() - GridWorld()['G'].longitude() , ddmAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( TrackSentencesRoundTrip )
+{
+    const GridWorld gridworld(Earth::EquatorialAntiMeridian, 1000, 10);
+    const GridWorldTrack track("A1B2G3S", 10, 0, gridworld);
+    const Track expected = track.toTrack(5, 0);
+
+    std::string fileName = "/tmp/nmea-testsXXXXXX";
+    const int fileDescriptor = ::mkstemp(&fileName[0]);
+    BOOST_REQUIRE( fileDescriptor >= 0 );
+    track.toNMEA(5, fileDescriptor);
+    ::close(fileDescriptor);
+    std::vector<Position> route = routeFromNMEALog(fileName);
+    std::remove(fileName.c_str());
+
+    // Each point is read from its GGA, RMC and GLL sentences in turn; only GGA includes the elevation.
+    BOOST_REQUIRE_EQUAL( route.size() , 3 * expected.numPositions() );
+    for (unsigned int i = 0; i < expected.numPositions(); ++i)
+    {
+        for (unsigned int s = 0; s < 3; ++s)
+        {
+            const Position & pos = route[3 * i + s];
+            BOOST_CHECK_SMALL( pos.latitude() - expected[i].latitude() , ddmAccuracy );
+            BOOST_CHECK_SMALL( std::abs(normaliseDeg(pos.longitude() - expected[i].longitude())) , ddmAccuracy );
+        }
+        BOOST_CHECK_SMALL( route[3 * i].elevation() - expected[i].elevation() , 0.05 );
+        BOOST_CHECK_EQUAL( route[3 * i + 2].elevation() , 0 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( StreamedTrackMatchesString )
+{
+    const GridWorldTrack track("A3B2C1H0H7M", 10, 0, GridWorld(Earth::EquatorialAntiMeridian));
+
+    std::FILE * file = std::tmpfile();
+    BOOST_REQUIRE( file != nullptr );
+    track.toNMEA(1, fileno(file));
+
+    std::string streamed;
+    std::rewind(file);
+    char buffer[4096];
+    std::size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) streamed.append(buffer, count);
+    std::fclose(file);
+
+    BOOST_CHECK( streamed == track.toNMEA(1) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /////////////////////////////////////////////////////////////////////////////////////////
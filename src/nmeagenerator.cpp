@@ -0,0 +1,179 @@
+#include <cmath>
+#include <cstring>
+
+#include "nmeagenerator.h"
+
+namespace NMEA
+{
+ namespace Generator
+ {
+  using GPS::degrees;
+  using GPS::seconds;
+  using GPS::Position;
+
+  namespace
+  {
+      const seconds secondsPerDay = 24 * 60 * 60;
+
+      char * writeLiteral(char * out, const char * literal)
+      {
+          const std::size_t length = std::strlen(literal);
+          std::memcpy(out, literal, length);
+          return out + length;
+      }
+
+      // Writes exactly "width" digits, zero-padded.
+      char * writeDigits(char * out, unsigned long long value, unsigned int width)
+      {
+          for (unsigned int i = width; i > 0; --i)
+          {
+              out[i-1] = static_cast<char>('0' + value % 10);
+              value /= 10;
+          }
+          return out + width;
+      }
+
+      // Writes a non-negative integer with no padding.
+      char * writeUnsigned(char * out, unsigned long long value)
+      {
+          char digits[20];
+          unsigned int count = 0;
+          do
+          {
+              digits[count++] = static_cast<char>('0' + value % 10);
+              value /= 10;
+          } while (value > 0);
+          while (count > 0) *out++ = digits[--count];
+          return out;
+      }
+
+      // hhmmss.sss (UTC)
+      char * writeTime(char * out, seconds time)
+      {
+          const seconds timeOfDay = time % secondsPerDay;
+          out = writeDigits(out, timeOfDay / 3600, 2);
+          out = writeDigits(out, (timeOfDay / 60) % 60, 2);
+          out = writeDigits(out, timeOfDay % 60, 2);
+          return writeLiteral(out, ".000");
+      }
+
+      // ddmmyy (UTC)
+      char * writeDate(char * out, seconds time)
+      /*
+       * Converts days since 1970-01-01 to a civil date.
+       * See: http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+       */
+      {
+          const long long days = static_cast<long long>(time / secondsPerDay) + 719468;
+          const long long era = days / 146097;
+          const unsigned long long dayOfEra = static_cast<unsigned long long>(days - era * 146097);
+          const unsigned long long yearOfEra = (dayOfEra - dayOfEra/1460 + dayOfEra/36524 - dayOfEra/146096) / 365;
+          const unsigned long long dayOfYear = dayOfEra - (365*yearOfEra + yearOfEra/4 - yearOfEra/100);
+          const unsigned long long mp = (5*dayOfYear + 2) / 153;
+          const unsigned long long day = dayOfYear - (153*mp + 2)/5 + 1;
+          const unsigned long long month = mp < 10 ? mp + 3 : mp - 9;
+          const unsigned long long year = yearOfEra + era * 400 + (month <= 2);
+
+          out = writeDigits(out, day, 2);
+          out = writeDigits(out, month, 2);
+          return writeDigits(out, year % 100, 2);
+      }
+
+      /* Writes the absolute value of an angle in DDM format (degrees, then minutes to 4 decimal
+       * places), followed by the bearing field.
+       */
+      char * writeDDM(char * out, degrees angle, unsigned int degreeDigits, char positive, char negative)
+      {
+          const unsigned long long minuteScale = 10000;
+          const unsigned long long totalMinutes = std::llround(std::abs(angle) * 60 * minuteScale);
+          const unsigned long long wholeDegrees = totalMinutes / (60 * minuteScale);
+          const unsigned long long minutes = totalMinutes % (60 * minuteScale);
+
+          out = writeDigits(out, wholeDegrees, degreeDigits);
+          out = writeDigits(out, minutes / minuteScale, 2);
+          *out++ = '.';
+          out = writeDigits(out, minutes % minuteScale, 4);
+          *out++ = ',';
+          *out++ = (angle < 0) ? negative : positive;
+          return out;
+      }
+
+      char * writeLatLon(char * out, const Position & pos)
+      {
+          out = writeDDM(out, pos.latitude(), 2, 'N', 'S');
+          *out++ = ',';
+          return writeDDM(out, pos.longitude(), 3, 'E', 'W');
+      }
+
+      // Elevation to 1 decimal place.
+      char * writeElevation(char * out, GPS::metres ele)
+      {
+          const long long tenths = std::llround(ele * 10);
+          if (tenths < 0) *out++ = '-';
+          const unsigned long long magnitude = static_cast<unsigned long long>(tenths < 0 ? -tenths : tenths);
+          out = writeUnsigned(out, magnitude / 10);
+          *out++ = '.';
+          *out++ = static_cast<char>('0' + magnitude % 10);
+          return out;
+      }
+
+      // Appends "*hh\n", where hh is the XOR of all characters after the '$'.
+      std::size_t finishSentence(char * begin, char * out)
+      {
+          const char hexDigits[] = "0123456789ABCDEF";
+          unsigned char checksum = 0;
+          for (const char * c = begin + 1; c != out; ++c) checksum ^= static_cast<unsigned char>(*c);
+
+          *out++ = '*';
+          *out++ = hexDigits[checksum >> 4];
+          *out++ = hexDigits[checksum & 0xF];
+          *out++ = '\n';
+          return static_cast<std::size_t>(out - begin);
+      }
+
+      std::size_t writeGGA(char * buffer, const Position & pos, const seconds * time)
+      {
+          char * out = writeLiteral(buffer, "$GPGGA,");
+          if (time != nullptr) out = writeTime(out, *time);
+          *out++ = ',';
+          out = writeLatLon(out, pos);
+          out = writeLiteral(out, ",1,0,,");
+          out = writeElevation(out, pos.elevation());
+          out = writeLiteral(out, ",M,,M,,");
+          return finishSentence(buffer, out);
+      }
+  }
+
+  std::size_t writeGLL(char * buffer, const Position & pos, seconds time)
+  {
+      char * out = writeLiteral(buffer, "$GPGLL,");
+      out = writeLatLon(out, pos);
+      *out++ = ',';
+      out = writeTime(out, time);
+      out = writeLiteral(out, ",A");
+      return finishSentence(buffer, out);
+  }
+
+  std::size_t writeGGA(char * buffer, const Position & pos, seconds time)
+  {
+      return writeGGA(buffer, pos, &time);
+  }
+
+  std::size_t writeGGA(char * buffer, const Position & pos)
+  {
+      return writeGGA(buffer, pos, nullptr);
+  }
+
+  std::size_t writeRMC(char * buffer, const Position & pos, seconds time)
+  {
+      char * out = writeLiteral(buffer, "$GPRMC,");
+      out = writeTime(out, time);
+      out = writeLiteral(out, ",A,");
+      out = writeLatLon(out, pos);
+      out = writeLiteral(out, ",0.000,0.00,");
+      out = writeDate(out, time);
+      out = writeLiteral(out, ",,A");
+      return finishSentence(buffer, out);
+  }
+ }
+}
@@ -0,0 +1,228 @@
+#include <cstdint>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+
+#include "parseNMEA.h"
+#include "trace.h"
+
+namespace GPS
+{
+  namespace
+  {
+      /* Sentence types are exactly 5 characters long (e.g. "GPGLL"), so they can be packed
+       * into the low 40 bits of an integer.  Dispatching then costs one integer comparison
+       * rather than a string comparison.
+       */
+      const std::size_t sentenceTypeLength = 5;
+
+      using SentenceKey = std::uint64_t;
+
+      constexpr SentenceKey packSentenceType(const char * type)
+      {
+          SentenceKey key = 0;
+          for (std::size_t i = 0; i < sentenceTypeLength; ++i)
+          {
+              key = (key << 8) | static_cast<unsigned char>(type[i]);
+          }
+          return key;
+      }
+
+      // Check that a field holds exactly one of the two permitted bearing characters.
+      char bearing(const std::string & field, char positive, char negative)
+      {
+          if (field.length() != 1 || (field[0] != positive && field[0] != negative))
+              throw std::invalid_argument("'" + field + "' is not a valid " + positive + "/" + negative + " bearing field.");
+          return field[0];
+      }
+
+      /* Each routine receives the sentence fields (excluding the sentence type and checksum),
+       * and the index of the first latitude field.
+       */
+      Position positionFromFields(const std::vector<std::string> & fields, std::size_t latIndex,
+                                  const std::string & eleStr = "0")
+      {
+          if (fields.size() < latIndex + 4)
+              throw std::invalid_argument("Missing latitude/longitude fields in NMEA sentence.");
+
+          char northing = bearing(fields[latIndex+1], 'N', 'S');
+          char easting  = bearing(fields[latIndex+3], 'E', 'W');
+          return Position(fields[latIndex], northing, fields[latIndex+2], easting, eleStr);
+      }
+
+      // $GPGLL,lat,N/S,lon,E/W,time
+      Position extractGLL(const std::vector<std::string> & fields)
+      {
+          return positionFromFields(fields, 0);
+      }
+
+      // $GPGGA,time,lat,N/S,lon,E/W,fix,satellites,HDOP,altitude,M,...
+      Position extractGGA(const std::vector<std::string> & fields)
+      {
+          if (fields.size() < 10 || fields[9] != "M")
+              throw std::invalid_argument("Missing altitude fields in GGA sentence.");
+          return positionFromFields(fields, 1, fields[8]);
+      }
+
+      // $GPRMC,time,status,lat,N/S,lon,E/W,...
+      Position extractRMC(const std::vector<std::string> & fields)
+      {
+          return positionFromFields(fields, 2);
+      }
+
+      using Extractor = Position (*)(const std::vector<std::string> &);
+
+      struct SentenceHandler
+      {
+          SentenceKey key;
+          Extractor extract;
+      };
+
+      /* Supported sentence types.  To support a further type, register it here;
+       * the static_assert below verifies that the hash remains perfect.
+       */
+      constexpr SentenceHandler sentenceHandlers[] =
+      {
+          { packSentenceType("GPGLL"), extractGLL },
+          { packSentenceType("GPGGA"), extractGGA },
+          { packSentenceType("GPRMC"), extractRMC },
+      };
+
+      /* Perfect hash from the packed key to a slot in the dispatch table.
+       * Only the final three characters vary between the registered types.
+       */
+      const std::size_t dispatchTableSize = 8;
+
+      constexpr std::size_t dispatchSlot(SentenceKey key)
+      {
+          return static_cast<std::size_t>(((key & 0xFFFFFF) * 0x9E3779B1u) >> 29) % dispatchTableSize;
+      }
+
+      constexpr bool isPerfectHash()
+      {
+          for (const SentenceHandler & a : sentenceHandlers)
+              for (const SentenceHandler & b : sentenceHandlers)
+                  if (&a != &b && dispatchSlot(a.key) == dispatchSlot(b.key)) return false;
+          return true;
+      }
+
+      static_assert(isPerfectHash(), "NMEA sentence types collide in the dispatch table.");
+
+      struct DispatchTable
+      {
+          SentenceHandler slots[dispatchTableSize];
+
+          constexpr DispatchTable() : slots{}
+          {
+              for (const SentenceHandler & handler : sentenceHandlers)
+                  slots[dispatchSlot(handler.key)] = handler;
+          }
+      };
+
+      constexpr DispatchTable dispatchTable;
+
+      // Returns nullptr for unsupported sentence types.
+      Extractor findExtractor(const char * type, std::size_t length)
+      {
+          if (length != sentenceTypeLength) return nullptr;
+          const SentenceKey key = packSentenceType(type);
+          const SentenceHandler & handler = dispatchTable.slots[dispatchSlot(key)];
+          return (handler.extract != nullptr && handler.key == key) ? handler.extract : nullptr;
+      }
+
+      int hexDigitValue(char c)
+      {
+          if (c >= '0' && c <= '9') return c - '0';
+          if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+          if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+          return -1;
+      }
+  }
+
+  bool isValidSentence(const std::string & sentence)
+  {
+      // Shortest possible sentence: "$GPxxx," followed by "*hh".
+      const std::size_t minLength = 1 + sentenceTypeLength + 1 + 3;
+      if (sentence.length() < minLength) return false;
+
+      if (sentence[0] != '$' || sentence[1] != 'G' || sentence[2] != 'P') return false;
+      for (std::size_t i = 3; i <= sentenceTypeLength; ++i)
+      {
+          if (! std::isupper(static_cast<unsigned char>(sentence[i]))) return false;
+      }
+      if (sentence[sentenceTypeLength+1] != ',') return false;
+
+      const std::size_t checksumBegin = sentence.length() - 2;
+      if (sentence[checksumBegin-1] != '*') return false;
+
+      const int high = hexDigitValue(sentence[checksumBegin]);
+      const int low  = hexDigitValue(sentence[checksumBegin+1]);
+      if (high < 0 || low < 0) return false;
+
+      unsigned char checksum = 0;
+      for (std::size_t i = 1; i < checksumBegin-1; ++i)
+      {
+          checksum ^= static_cast<unsigned char>(sentence[i]);
+      }
+      return checksum == (high << 4 | low);
+  }
+
+  NMEAPair decomposeSentence(const std::string & nmeaSentence)
+  {
+      const std::size_t fieldsBegin = sentenceTypeLength + 2;
+      const std::size_t fieldsEnd   = nmeaSentence.length() - 3; // Position of the '*'.
+
+      NMEAPair decomposed;
+      decomposed.first = nmeaSentence.substr(1, sentenceTypeLength);
+
+      std::size_t fieldBegin = fieldsBegin;
+      while (true)
+      {
+          std::size_t fieldEnd = nmeaSentence.find(',', fieldBegin);
+          if (fieldEnd == std::string::npos || fieldEnd > fieldsEnd) fieldEnd = fieldsEnd;
+          decomposed.second.push_back(nmeaSentence.substr(fieldBegin, fieldEnd - fieldBegin));
+          if (fieldEnd == fieldsEnd) break;
+          fieldBegin = fieldEnd + 1;
+      }
+
+      return decomposed;
+  }
+
+  Position extractPosition(const NMEAPair & nmeaPair)
+  {
+      Extractor extract = findExtractor(nmeaPair.first.data(), nmeaPair.first.length());
+      if (extract == nullptr)
+          throw std::invalid_argument("Unsupported NMEA sentence type: " + nmeaPair.first);
+
+      return extract(nmeaPair.second);
+  }
+
+  std::vector<Position> routeFromNMEALog(const std::string & filepath)
+  {
+      Trace::Span span("routeFromNMEALog");
+      std::ifstream file(filepath);
+      if (! file.good())
+          throw std::invalid_argument("Error opening NMEA log file '" + filepath + "'.");
+
+      std::vector<Position> positions;
+      std::string line;
+      while (std::getline(file, line))
+      {
+          if (! line.empty() && line.back() == '\r') line.pop_back();
+          if (! isValidSentence(line)) continue;
+
+          // Reject unsupported sentence types (GSV, GSA, VTG, ...) before splitting any fields.
+          Extractor extract = findExtractor(line.data() + 1, sentenceTypeLength);
+          if (extract == nullptr) continue;
+
+          try
+          {
+              positions.push_back(extract(decomposeSentence(line).second));
+          }
+          catch (const std::invalid_argument &) {} // Ill-formed sentences are ignored.
+          catch (const std::out_of_range &) {}
+      }
+
+      return positions;
+  }
+}
@@ -1,6 +1,8 @@
 #include <cassert>
+#include <cctype>
+#include <charconv>
 #include <cmath>
-#include <sstream>
+#include <cstring>
 #include <stdexcept>
 
 #include "geometry.h"
@@ -71,15 +73,33 @@ namespace GPS
 
   std::string Position::toString(bool includeElevation) const
   {
-      std::ostringstream oss;
+      char buffer[maxFormattedLength];
+      return std::string(buffer, formatTo(buffer, includeElevation));
+  }
 
-      oss <<  "lat=\"" << lat << "\"";
-      oss << " lon=\"" << lon << "\"";
-      if (includeElevation) {
-          oss << " ele=\"" << ele << "\"";
+  namespace
+  {
+      char * formatAttribute(char * out, const char * prefix, std::size_t prefixLength, double value)
+      {
+          // Matches the default stream formatting (6 significant digits) used by existing GPX files.
+          const int significantDigits = 6;
+          const std::size_t maxValueLength = 24;
+          std::memcpy(out, prefix, prefixLength);
+          out = std::to_chars(out + prefixLength, out + prefixLength + maxValueLength, value,
+                              std::chars_format::general, significantDigits).ptr;
+          *out++ = '"';
+          return out;
       }
+  }
 
-      return oss.str();
+  char * Position::formatTo(char * buffer, bool includeElevation) const
+  {
+      char * out = formatAttribute(buffer, "lat=\"", 5, lat);
+      out = formatAttribute(out, " lon=\"", 6, lon);
+      if (includeElevation) {
+          out = formatAttribute(out, " ele=\"", 6, ele);
+      }
+      return out;
   }
 
   metres Position::distanceBetween(const Position & p1, const Position & p2)
@@ -97,10 +117,67 @@ namespace GPS
   }
 
   degrees ddmTodd(const std::string & ddmStr)
+  /*
+   * DDM values are decimal fixed-point: "3722.5993" is 37 degrees and 22.5993 minutes.
+   * All digits are read into a single integer (37225993, with 4 fractional digits), so the
+   * degrees and minutes separate exactly and only the final division rounds.
+   * Like std::stod, leading whitespace is skipped and parsing stops at the first character
+   * that cannot continue the number.
+   */
   {
-      double ddm  = std::stod(ddmStr);
-      double degs = std::floor(ddm / 100);
-      double mins = ddm - 100 * degs;
-      return degs + mins / 60.0; // converts minutes (1/60th) to decimal fractions of a degree
+      const unsigned int maxFractionalDigits = 15;
+      const unsigned long long maxDigits = 1000000000000000000ULL; // Keeps digits*10 within 64 bits.
+
+      std::size_t i = 0;
+      while (i < ddmStr.length() && std::isspace(static_cast<unsigned char>(ddmStr[i]))) ++i;
+
+      bool negative = false;
+      if (i < ddmStr.length() && (ddmStr[i] == '-' || ddmStr[i] == '+'))
+      {
+          negative = (ddmStr[i] == '-');
+          ++i;
+      }
+
+      unsigned long long digits = 0;
+      unsigned long long scale = 1; // 10^fractionalDigits
+      unsigned int fractionalDigits = 0;
+      bool anyDigits = false;
+      bool inFraction = false;
+      for (; i < ddmStr.length(); ++i)
+      {
+          const char c = ddmStr[i];
+          if (c == '.' && ! inFraction)
+          {
+              inFraction = true;
+              continue;
+          }
+          if (c < '0' || c > '9') break;
+
+          anyDigits = true;
+          if (inFraction)
+          {
+              // Digits beyond the representable precision are truncated.
+              if (fractionalDigits < maxFractionalDigits && digits < maxDigits)
+              {
+                  digits = digits * 10 + (c - '0');
+                  scale *= 10;
+                  ++fractionalDigits;
+              }
+          }
+          else
+          {
+              if (digits >= maxDigits)
+                  throw std::out_of_range("DDM value '" + ddmStr + "' is out of range.");
+              digits = digits * 10 + (c - '0');
+          }
+      }
+
+      if (! anyDigits)
+          throw std::invalid_argument("'" + ddmStr + "' is not a valid DDM value.");
+
+      const unsigned long long degs = digits / (100 * scale);
+      const unsigned long long minsScaled = digits % (100 * scale);
+      const degrees dd = static_cast<double>(degs * 60 * scale + minsScaled) / static_cast<double>(60 * scale);
+      return negative ? -dd : dd;
   }
 }
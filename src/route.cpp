@@ -2,17 +2,56 @@
 #include <sstream>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <cassert>
 #include <cmath>
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 
 #include "geometry.h"
 #include "xmlparser.h"
 #include "route.h"
+#include "trace.h"
 
 using namespace GPS;
 
+namespace
+{
+    // The 3D distance between successive route points.
+    metres segmentLength(const Position & p1, const Position & p2)
+    {
+        metres deltaH = Position::distanceBetween(p1, p2);
+        metres deltaV = p1.elevation() - p2.elevation();
+        return sqrt(pow(deltaH,2) + pow(deltaV,2));
+    }
+
+    // One coordinate of every Position.
+    std::vector<double> column(const std::vector<Position> & positions, double (Position::*coordinate)() const)
+    {
+        std::vector<double> values;
+        values.reserve(positions.size());
+        for (const Position & pos : positions) values.push_back((pos.*coordinate)());
+        return values;
+    }
+
+    // The least coordinate (according to "better") from positions[from] to positions[to], by scanning.
+    template <typename Compare>
+    double scanRange(const std::vector<Position> & positions, unsigned int from, unsigned int to,
+                     double (Position::*coordinate)() const, Compare better)
+    {
+        double extreme = (positions[from].*coordinate)();
+        for (unsigned int i = from + 1; i <= to; ++i)
+        {
+            const double value = (positions[i].*coordinate)();
+            if (better(value, extreme)) extreme = value;
+        }
+        return extreme;
+    }
+}
+
 std::string Route::name() const
 {
     return routeName.empty() ? "Unnamed Route" : routeName;
@@ -44,15 +83,19 @@ metres Route::netLength() const
 
 metres Route::totalHeightGain() const
 {
-    assert(! positions.empty());
-
-    metres total = 0.0;
-    for (unsigned int i = 1; i < numPositions(); ++i)
+    return statisticsCache->totalHeightGain.get([this] () -> metres
     {
-        metres deltaV = positions[i].elevation() - positions[i-1].elevation();
-        if (deltaV > 0.0) total += deltaV; // ignore negative height differences
-    }
-    return total;
+        Trace::Span span("Route::totalHeightGain");
+        assert(! positions.empty());
+
+        metres total = 0.0;
+        for (unsigned int i = 1; i < numPositions(); ++i)
+        {
+            metres deltaV = positions[i].elevation() - positions[i-1].elevation();
+            if (deltaV > 0.0) total += deltaV; // ignore negative height differences
+        }
+        return total;
+    });
 }
 
 metres Route::netHeightGain() const
@@ -63,137 +106,283 @@ metres Route::netHeightGain() const
     return std::max(deltaV,0.0); // ignore negative height differences
 }
 
-degrees Route::minLatitude() const
+metres Route::totalLength(unsigned int from, unsigned int to) const
 {
-    if (positions.empty()) {
-        throw std::out_of_range("Cannot get the minimum latitude of an empty route");
-    }
+    checkRange(from, to);
+    const std::vector<metres> & prefixSums = statisticsCache->lengthPrefixSums.get([this] ()
+    {
+        Trace::Span span("Route::lengthPrefixSums");
+        std::vector<metres> sums(positions.size());
+        for (std::size_t i = 1; i < positions.size(); ++i)
+        {
+            sums[i] = sums[i-1] + segmentLength(positions[i-1], positions[i]);
+        }
+        return sums;
+    });
+    return prefixSums[to] - prefixSums[from];
+}
 
-    degrees lowestLatitude = positions[0].latitude();
+metres Route::totalHeightGain(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    const std::vector<metres> & prefixSums = statisticsCache->heightGainPrefixSums.get([this] ()
+    {
+        Trace::Span span("Route::heightGainPrefixSums");
+        std::vector<metres> sums(positions.size());
+        for (std::size_t i = 1; i < positions.size(); ++i)
+        {
+            metres deltaV = positions[i].elevation() - positions[i-1].elevation();
+            sums[i] = sums[i-1] + std::max(deltaV,0.0); // ignore negative height differences
+        }
+        return sums;
+    });
+    return prefixSums[to] - prefixSums[from];
+}
 
-    double epsilon = 0.0001;
+metres Route::netHeightGain(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    metres deltaV = positions[to].elevation() - positions[from].elevation();
+    return std::max(deltaV,0.0);
+}
 
-    for (int i = 0; i < positions.size(); i++)
+degrees Route::minLatitude() const
+{
+    return statisticsCache->minLatitude.get([this] () -> degrees
     {
-        if ( (positions[i].latitude() - lowestLatitude) < epsilon)
+        Trace::Span span("Route::minLatitude");
+        if (positions.empty()) {
+            throw std::out_of_range("Cannot get the minimum latitude of an empty route");
+        }
+
+        degrees lowestLatitude = positions[0].latitude();
+
+        double epsilon = 0.0001;
+
+        for (int i = 0; i < positions.size(); i++)
         {
-            lowestLatitude = positions[i].latitude();
+            if ( (positions[i].latitude() - lowestLatitude) < epsilon)
+            {
+                lowestLatitude = positions[i].latitude();
+            }
         }
-    }
 
-    return lowestLatitude;
+        return lowestLatitude;
+    });
 }
 
 degrees Route::maxLatitude() const
 {
-    degrees currentMax = positions[0].latitude();
+    return statisticsCache->maxLatitude.get([this] () -> degrees
+    {
+        Trace::Span span("Route::maxLatitude");
+        degrees currentMax = positions[0].latitude();
 
-    for(int i = 0; i < positions.size(); i++){
-        if(positions[i].latitude() > currentMax)
-            currentMax = positions[i].latitude();
-    }
+        for(int i = 0; i < positions.size(); i++){
+            if(positions[i].latitude() > currentMax)
+                currentMax = positions[i].latitude();
+        }
 
-    return currentMax;
+        return currentMax;
+    });
 }
 
 degrees Route::minLongitude() const     //MY FUNCTION
 {
-    assert(! positions.empty());
-
-    degrees minLon = positions.front().longitude();
-    for (const Position& pos : positions)
+    return statisticsCache->minLongitude.get([this] () -> degrees
     {
-        minLon = std::min(minLon,pos.longitude());
-    }
-    return minLon;
+        Trace::Span span("Route::minLongitude");
+        assert(! positions.empty());
+
+        degrees minLon = positions.front().longitude();
+        for (const Position& pos : positions)
+        {
+            minLon = std::min(minLon,pos.longitude());
+        }
+        return minLon;
+    });
 }
 
 degrees Route::maxLongitude() const
 {
-    assert(! positions.empty());
-
-    degrees maxLon = positions.front().longitude();
-    for (const Position& pos : positions)
+    return statisticsCache->maxLongitude.get([this] () -> degrees
     {
-        maxLon = std::max(maxLon,pos.longitude());
-    }
-    return maxLon;
+        Trace::Span span("Route::maxLongitude");
+        assert(! positions.empty());
 
+        degrees maxLon = positions.front().longitude();
+        for (const Position& pos : positions)
+        {
+            maxLon = std::max(maxLon,pos.longitude());
+        }
+        return maxLon;
+
+    });
 }
 
 metres Route::minElevation() const
 {
-    assert(! positions.empty());
-
-    degrees minEle = positions.front().elevation();
-    for (const Position& pos : positions)
+    return statisticsCache->minElevation.get([this] () -> metres
     {
-        minEle = std::min(minEle,pos.elevation());
-    }
-    return minEle;
+        Trace::Span span("Route::minElevation");
+        assert(! positions.empty());
+
+        degrees minEle = positions.front().elevation();
+        for (const Position& pos : positions)
+        {
+            minEle = std::min(minEle,pos.elevation());
+        }
+        return minEle;
+    });
 }
 
 metres Route::maxElevation() const
 {
-    assert(! positions.empty());
-
-    degrees maxEle = positions.front().elevation();
-    for (const Position& pos : positions)
+    return statisticsCache->maxElevation.get([this] () -> metres
     {
-        maxEle = std::max(maxEle,pos.elevation());
-    }
-    return maxEle;
+        Trace::Span span("Route::maxElevation");
+        assert(! positions.empty());
+
+        degrees maxEle = positions.front().elevation();
+        for (const Position& pos : positions)
+        {
+            maxEle = std::max(maxEle,pos.elevation());
+        }
+        return maxEle;
+    });
 }
 
 degrees Route::maxGradient() const
 {
-    assert(! positions.empty());
+    return statisticsCache->maxGradient.get([this] () -> degrees
+    {
+        Trace::Span span("Route::maxGradient");
+        assert(! positions.empty());
 
-    if (positions.size() == 1) return 0.0;
+        if (positions.size() == 1) return 0.0;
 
-    degrees maxGrad = -halfRotation/2; // minimum possible value
-    for (unsigned int i = 1; i < positions.size(); ++i)
-    {
-        metres deltaH = Position::distanceBetween(positions[i],positions[i-1]);
-        metres deltaV = positions[i].elevation() - positions[i-1].elevation();
-        degrees grad = radToDeg(std::atan(deltaV/deltaH));
-        maxGrad = std::max(maxGrad,grad);
-    }
-    return maxGrad;
+        degrees maxGrad = -halfRotation/2; // minimum possible value
+        for (unsigned int i = 1; i < positions.size(); ++i)
+        {
+            metres deltaH = Position::distanceBetween(positions[i],positions[i-1]);
+            metres deltaV = positions[i].elevation() - positions[i-1].elevation();
+            degrees grad = radToDeg(std::atan(deltaV/deltaH));
+            maxGrad = std::max(maxGrad,grad);
+        }
+        return maxGrad;
+    });
 }
 
 degrees Route::minGradient() const
 {
-    assert(! positions.empty());
+    return statisticsCache->minGradient.get([this] () -> degrees
+    {
+        Trace::Span span("Route::minGradient");
+        assert(! positions.empty());
 
-    if (positions.size() == 1) return 0.0;
+        if (positions.size() == 1) return 0.0;
 
-    degrees minGrad = halfRotation/2; // maximum possible value
-    for (unsigned int i = 1; i < positions.size(); ++i)
-    {
-        metres deltaH = Position::distanceBetween(positions[i],positions[i-1]);
-        metres deltaV = positions[i].elevation() - positions[i-1].elevation();
-        degrees grad = radToDeg(std::atan(deltaV/deltaH));
-        minGrad = std::min(minGrad,grad);
-    }
-    return minGrad;
+        degrees minGrad = halfRotation/2; // maximum possible value
+        for (unsigned int i = 1; i < positions.size(); ++i)
+        {
+            metres deltaH = Position::distanceBetween(positions[i],positions[i-1]);
+            metres deltaV = positions[i].elevation() - positions[i-1].elevation();
+            degrees grad = radToDeg(std::atan(deltaV/deltaH));
+            minGrad = std::min(minGrad,grad);
+        }
+        return minGrad;
+    });
 }
 
 degrees Route::steepestGradient() const
 {
-    assert(! positions.empty());
+    return statisticsCache->steepestGradient.get([this] () -> degrees
+    {
+        Trace::Span span("Route::steepestGradient");
+        assert(! positions.empty());
+
+        if (positions.size() == 1) return 0.0;
+
+        degrees maxGrad = -halfRotation/2; // minimum possible value
+        for (unsigned int i = 1; i < positions.size(); ++i)
+        {
+            metres deltaH = Position::distanceBetween(positions[i],positions[i-1]);
+            metres deltaV = positions[i].elevation() - positions[i-1].elevation();
+            degrees grad = radToDeg(std::atan(deltaV/deltaH));
+            maxGrad = std::max(maxGrad,std::abs(grad));
+        }
+        return maxGrad;
+    });
+}
+
+degrees Route::minLatitude(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    if (rangeIndex) return rangeIndex->minLatitude.query(from, to);
+    return scanRange(positions, from, to, &Position::latitude, std::less<degrees>());
+}
+
+degrees Route::maxLatitude(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    if (rangeIndex) return rangeIndex->maxLatitude.query(from, to);
+    return scanRange(positions, from, to, &Position::latitude, std::greater<degrees>());
+}
+
+degrees Route::minLongitude(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    if (rangeIndex) return rangeIndex->minLongitude.query(from, to);
+    return scanRange(positions, from, to, &Position::longitude, std::less<degrees>());
+}
 
-    if (positions.size() == 1) return 0.0;
+degrees Route::maxLongitude(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    if (rangeIndex) return rangeIndex->maxLongitude.query(from, to);
+    return scanRange(positions, from, to, &Position::longitude, std::greater<degrees>());
+}
+
+metres Route::minElevation(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    if (rangeIndex) return rangeIndex->minElevation.query(from, to);
+    return scanRange(positions, from, to, &Position::elevation, std::less<metres>());
+}
 
-    degrees maxGrad = -halfRotation/2; // minimum possible value
-    for (unsigned int i = 1; i < positions.size(); ++i)
+metres Route::maxElevation(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    if (rangeIndex) return rangeIndex->maxElevation.query(from, to);
+    return scanRange(positions, from, to, &Position::elevation, std::greater<metres>());
+}
+
+void Route::buildRangeIndex()
+{
+    const std::chrono::nanoseconds previousBuilds = stats.buildRangeIndex;
     {
-        metres deltaH = Position::distanceBetween(positions[i],positions[i-1]);
-        metres deltaV = positions[i].elevation() - positions[i-1].elevation();
-        degrees grad = radToDeg(std::atan(deltaV/deltaH));
-        maxGrad = std::max(maxGrad,std::abs(grad));
+        LoadStats::PhaseTimer timer(stats.buildRangeIndex);
+        Trace::Span span("Route::buildRangeIndex");
+        std::vector<degrees> latitudes = column(positions, &Position::latitude);
+        std::vector<degrees> longitudes = column(positions, &Position::longitude);
+        std::vector<metres> elevations = column(positions, &Position::elevation);
+        rangeIndex = std::make_unique<const RangeIndex>(RangeIndex{
+            SparseTable<degrees>(latitudes), SparseTable<degrees,std::greater<degrees>>(std::move(latitudes)),
+            SparseTable<degrees>(longitudes), SparseTable<degrees,std::greater<degrees>>(std::move(longitudes)),
+            SparseTable<metres>(elevations), SparseTable<metres,std::greater<metres>>(std::move(elevations))});
+    }
+
+    reportStringStream << "Range index built: " << memoryUsage().rangeIndex << " bytes";
+    if (LoadStats::timingsEnabled) {
+        reportStringStream << ", " << (stats.buildRangeIndex - previousBuilds).count() << " ns";
     }
-    return maxGrad;
+    reportStringStream << "." << std::endl;
+    report = reportStringStream.str();
+}
+
+bool Route::hasRangeIndex() const
+{
+    return rangeIndex != nullptr;
 }
 
 Position Route::operator[](unsigned int idx) const
@@ -232,17 +421,12 @@ std::string Route::findNameOf(const Position & soughtPos) const
 
 unsigned int Route::timesVisited(const std::string & soughtName) const
 {
-    unsigned int timesVisited{0};
-
-    try{
-
-        Position position = this->findPosition(soughtName);
-        for (const auto &i: positions)
-            if (areSameLocation(i, position)) timesVisited++;
+    // Not via findPosition(), as an unknown name is not exceptional here, and throwing allocates.
+    auto nameIt = std::find(positionNames.begin(), positionNames.end(), soughtName);
 
-    } catch(const std::out_of_range& e){}
+    if (nameIt == positionNames.end()) return 0;
 
-    return timesVisited;
+    return timesVisited(positions[std::distance(positionNames.begin(),nameIt)]);
 }
 
 unsigned int Route::timesVisited(const Position & soughtPos) const
@@ -260,7 +444,55 @@ std::string Route::buildReport() const
     return report;
 }
 
-std::string Route::checkErrors(std::string& gpsData, std::string fileType){
+const LoadStats & Route::loadStats() const
+{
+    return stats;
+}
+
+std::size_t MemoryUsage::total() const
+{
+    return object + positions + positionNames + times + report + caches + rangeIndex;
+}
+
+namespace
+{
+    // The heap memory held by a string; short strings are stored inline, so hold none.
+    std::size_t heapBytes(const std::string & str)
+    {
+        const char * data = str.data();
+        const char * object = reinterpret_cast<const char *>(&str);
+        const bool isInline = data >= object && data < object + sizeof(str);
+        return isInline ? 0 : str.capacity() + 1;
+    }
+}
+
+MemoryUsage Route::memoryUsage() const
+{
+    MemoryUsage usage;
+    usage.object = sizeof(Route);
+    usage.positions = positions.capacity() * sizeof(Position);
+
+    usage.positionNames = positionNames.capacity() * sizeof(std::string);
+    for (const std::string & name : positionNames) usage.positionNames += heapBytes(name);
+
+    // The stream's buffer holds at least everything written to it.
+    const std::streamoff written = reportStringStream.rdbuf()->pubseekoff(0, std::ios_base::cur, std::ios_base::out);
+    usage.report = heapBytes(report) + static_cast<std::size_t>(std::max<std::streamoff>(written, 0));
+
+    usage.object += heapBytes(routeName);
+    if (rangeIndex) {
+        usage.rangeIndex = sizeof(RangeIndex) + rangeIndex->minLatitude.memoryUsage() + rangeIndex->maxLatitude.memoryUsage()
+                         + rangeIndex->minLongitude.memoryUsage() + rangeIndex->maxLongitude.memoryUsage()
+                         + rangeIndex->minElevation.memoryUsage() + rangeIndex->maxElevation.memoryUsage();
+    }
+    usage.caches = sizeof(StatisticsCache);
+    for (const Memo<std::vector<metres>> * prefixSums : {&statisticsCache->lengthPrefixSums, &statisticsCache->heightGainPrefixSums}) {
+        if (prefixSums->ifComputed()) usage.caches += prefixSums->ifComputed()->capacity() * sizeof(metres);
+    }
+    return usage;
+}
+
+std::string Route::checkErrors(std::string& gpsData, const std::string & fileType){
     std::string newPostion;
     if (! XML::Parser::elementExists(gpsData, fileType))
         throw std::domain_error("No '" + fileType +"' element.");
@@ -275,39 +507,49 @@ std::string Route::checkErrors(std::string& gpsData, std::string fileType){
     return newPostion;
 }
 
-std::string Route::readFileData(std::string fileName)
+std::string Route::readFileData(const std::string & fileName)
 {
-    std::ostringstream fileStringStream;
-    std::string line;
+    Trace::Span span("Route::readFileData");
     std::ifstream file(fileName);
 
     if (! file.good()) {
         throw std::invalid_argument("Error opening source file '" + fileName + "'.");
     }
 
-    while (getline(file, line)) {
-        fileStringStream << line << std::endl;
+    // Read the whole file at once, into a string of the right size, rather than line by line.
+    std::string fileData;
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size > 0) {
+        fileData.reserve(static_cast<std::size_t>(size) + 1); // Room for a final newline.
+        fileData.resize(static_cast<std::size_t>(size));
+        file.read(&fileData[0], size);
+        fileData.resize(static_cast<std::size_t>(file.gcount()));
+    } else {
+        file.clear();
+        fileData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
     }
 
-    return fileStringStream.str();
+    // As if read line by line, the last line always ends with a newline.
+    if (! fileData.empty() && fileData.back() != '\n') fileData += '\n';
+    return fileData;
 }
 
-std::string Route::setupFileData(std::vector<std::string> elements,std::string fileData){
+void Route::setupFileData(const std::vector<std::string> & elements, std::string & fileData){
+    Trace::Span span("Route::setupFileData");
 
-    for (int i = 0; i < elements.size(); ++i){
-        if (! XML::Parser::elementExists(fileData,elements[i])) 
-            throw std::domain_error("No '" + elements[i] + "' element.");
-        fileData = XML::Parser::getElementContent(XML::Parser::getElement(fileData, elements[i]));
+    for (const std::string & element : elements){
+        if (! XML::Parser::elementExists(fileData,element))
+            throw std::domain_error("No '" + element + "' element.");
+        XML::Parser::extractElementContent(fileData, element);
     }
     while (XML::Parser::elementExists(fileData, "trkseg")) {
-        std::string trkseg = XML::Parser::getElementContent(XML::Parser::getAndEraseElement(fileData, "trkseg"));
-        XML::Parser::getAndEraseElement(trkseg, "name");
-        fileData += trkseg;
+        XML::Parser::moveElementContentToEnd(fileData, "trkseg", "name");
     }
-    return fileData;
 }
 
-Position Route::getNewPostion(std::string newPostion){
+Position Route::getNewPostion(std::string_view newPostion){
     std::string lat,lon,ele;
     lat = XML::Parser::getElementAttribute(newPostion, "lat");
     lon = XML::Parser::getElementAttribute(newPostion, "lon");
@@ -318,7 +560,7 @@ Position Route::getNewPostion(std::string newPostion){
         return Position(lat,lon);
 }
 
-std::string Route::getName(std::string newPostion){
+std::string Route::getName(std::string_view newPostion){
     if (XML::Parser::elementExists(newPostion,"name")) {
         return XML::Parser::getElementContent(XML::Parser::getElement(newPostion,"name"));
     }
@@ -326,60 +568,295 @@ std::string Route::getName(std::string newPostion){
 }
 
 void Route::setRouteLength(){
-    metres deltaH,deltaV;
+    Trace::Span span("Route::setRouteLength");
     routeLength = 0;
     for (unsigned int i = 1; i < positions.size(); ++i ) {
-        deltaH = Position::distanceBetween(positions[i-1], positions[i]);
-        deltaV = positions[i-1].elevation() - positions[i].elevation();
-        routeLength += sqrt(pow(deltaH,2) + pow(deltaV,2));
+        routeLength += segmentLength(positions[i-1], positions[i]);
     }
 }
 
-void Route::addPostion(std::string newPostion){
-    positions.push_back(getNewPostion(newPostion));
+bool Route::appendPosition(const Position & position){
+    const bool kept = positions.empty() || ! areSameLocation(position, positions.back());
+    reportPosition(reportStringStream, position, 0, kept);
+    storePosition(position, 0, kept);
+    return kept;
+}
+
+Route::ParsedPoint Route::parsePoint(const std::string & element){
+    Position position = getNewPostion(element);
+    return {position, 0, getName(element)};
+}
+
+void Route::reportPosition(std::ostream & report, const Position & position, seconds, bool kept) const{
+    char formatted[Position::maxFormattedLength];
+    const char* formattedEnd = position.formatTo(formatted);
+    report << (kept ? "Position added: " : "Position ignored: ");
+    report.write(formatted, formattedEnd - formatted) << '\n';
+}
 
-    if (positions.size() > 1 && areSameLocation(positions.back(), positions.at(positions.size()-2))){
-        reportStringStream << "Position ignored: " << positions.back().toString() << std::endl;
-        positions.pop_back();
+void Route::storePosition(const Position & position, seconds, bool kept){
+    ++stats.pointsSeen;
+    if (kept) {
+        ++stats.pointsAccepted;
+        positions.push_back(position);
     } else {
-        positionNames.push_back(getName(newPostion));
-        reportStringStream << "Position added: " << positions.back().toString() << std::endl;
+        ++stats.pointsIgnored;
     }
 }
 
-Route::Route(std::string fileName, bool isFileName, metres granularity){
-    std::string newPostion;
+void Route::appendParsedPoint(const ParsedPoint & point){
+    const bool kept = positions.empty() || ! areSameLocation(point.position, positions.back());
+    reportPosition(reportStringStream, point.position, point.time, kept);
+    storePosition(point.position, point.time, kept);
+    if (kept) positionNames.push_back(point.name);
+}
+
+void Route::parsePoints(std::string & gpsData, const std::string & elementName, unsigned int threads){
+    if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1U);
+    if (threads > 1 && parsePointsInParallel(gpsData, elementName, threads)) return;
+
+    while (XML::Parser::elementExists(gpsData, elementName)) {
+        appendParsedPoint(parsePoint(checkErrors(gpsData, elementName)));
+    }
+}
+
+namespace
+{
+    /* The index of the next opening tag, e.g. "<trkpt", at or after "from", ignoring tags that
+     * merely start with the same characters (as XML::Parser does).
+     */
+    std::size_t findOpeningTag(const std::string & data, const std::string & tag, std::size_t from)
+    {
+        for (std::size_t pos = data.find(tag, from); pos != std::string::npos; pos = data.find(tag, pos + 1)) {
+            const std::size_t next = pos + tag.length();
+            if (next < data.length() && (data[next] == ' ' || data[next] == '>')) return pos;
+        }
+        return std::string::npos;
+    }
+}
+
+bool Route::parsePointsInParallel(const std::string & gpsData, const std::string & elementName, unsigned int threads){
+    const std::size_t minChunkLength = 64 * 1024;
+    const std::size_t chunksPerThread = 4; // So that threads finishing early can take another.
+    const std::size_t maxChunks = std::min<std::size_t>(threads * chunksPerThread, gpsData.length() / minChunkLength);
+    if (maxChunks < 2) return false;
+
+    // Chunks start at an opening tag, except the first, which starts at the beginning of the data.
+    const std::string tag = "<" + elementName;
+    std::vector<std::size_t> chunkBegins = {0};
+    for (std::size_t c = 1; c < maxChunks; ++c) {
+        const std::size_t target = std::max(c * gpsData.length() / maxChunks, chunkBegins.back() + 1);
+        const std::size_t begin = findOpeningTag(gpsData, tag, target);
+        if (begin == std::string::npos) break;
+        if (begin > chunkBegins.back()) chunkBegins.push_back(begin);
+    }
+    if (chunkBegins.size() < 2) return false;
+    chunkBegins.push_back(gpsData.length());
+
+    struct Chunk
+    {
+        std::vector<ParsedPoint> points;
+        std::vector<char> kept; // Filtered as if the first point were kept.
+        std::string report; // Reported as if the first point were kept.
+        std::vector<std::size_t> reportOffsets; // Of each point's report.
+        std::exception_ptr error;
+        bool spansSeam = false; // An element starts in this chunk and ends in the next.
+    };
+    const std::size_t numChunks = chunkBegins.size() - 1;
+    std::vector<Chunk> chunks(numChunks);
+
+    std::atomic<std::size_t> nextChunk {0};
+    auto worker = [&] ()
+    {
+        for (std::size_t c = nextChunk++; c < numChunks; c = nextChunk++) {
+            Chunk & chunk = chunks[c];
+            try {
+                std::string data = gpsData.substr(chunkBegins[c], chunkBegins[c+1] - chunkBegins[c]);
+                while (XML::Parser::elementExists(data, elementName)) {
+                    chunk.points.push_back(parsePoint(checkErrors(data, elementName)));
+                }
+                chunk.spansSeam = (c + 1 < numChunks) && findOpeningTag(data, tag, 0) != std::string::npos;
+
+                std::ostringstream report;
+                const Position * lastKept = nullptr;
+                for (const ParsedPoint & point : chunk.points) {
+                    const bool kept = lastKept == nullptr || ! areSameLocation(point.position, *lastKept);
+                    if (kept) lastKept = &point.position;
+                    chunk.kept.push_back(kept);
+                    chunk.reportOffsets.push_back(static_cast<std::size_t>(report.tellp()));
+                    reportPosition(report, point.position, point.time, kept);
+                }
+                chunk.reportOffsets.push_back(static_cast<std::size_t>(report.tellp()));
+                chunk.report = report.str();
+            } catch (...) {
+                chunk.error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < std::min<std::size_t>(threads, numChunks); ++t) pool.emplace_back(worker);
+    worker();
+    for (std::thread & thread : pool) thread.join();
+
+    // The first failure, in document order, is the one a sequential parse would have reported.
+    for (const Chunk & chunk : chunks) {
+        if (chunk.error) std::rethrow_exception(chunk.error);
+        if (chunk.spansSeam) return false;
+    }
+
+    for (const Chunk & chunk : chunks) {
+        // Re-filter from the seam, until a point is kept both here and by the chunk's own filtering;
+        // from then on, both filter against the same previous point, so agree.
+        std::size_t i = 0;
+        for (; i < chunk.points.size(); ++i) {
+            const ParsedPoint & point = chunk.points[i];
+            const bool kept = positions.empty() || ! areSameLocation(point.position, positions.back());
+            if (kept && chunk.kept[i]) break;
+            reportPosition(reportStringStream, point.position, point.time, kept);
+            storePosition(point.position, point.time, kept);
+            if (kept) positionNames.push_back(point.name);
+        }
+        reportStringStream.write(chunk.report.data() + chunk.reportOffsets[i],
+                                 chunk.report.length() - chunk.reportOffsets[i]);
+        for (; i < chunk.points.size(); ++i) {
+            const ParsedPoint & point = chunk.points[i];
+            storePosition(point.position, point.time, chunk.kept[i]);
+            if (chunk.kept[i]) positionNames.push_back(point.name);
+        }
+    }
+    return true;
+}
+
+void Route::finishConstruction(){
+    reportStringStream << positions.size() << " positions added." << std::endl;
+    {
+        LoadStats::PhaseTimer timer(stats.setRouteLength);
+        setRouteLength();
+    }
+
+    reportStringStream << "Points seen: " << stats.pointsSeen
+                       << ", accepted: " << stats.pointsAccepted
+                       << ", ignored: " << stats.pointsIgnored
+                       << ", bytes scanned: " << stats.bytesScanned << "." << std::endl;
+    if (LoadStats::timingsEnabled) {
+        reportStringStream << "Load timings (ns): read file " << stats.readFile.count()
+                           << ", setupFileData " << stats.setupFileData.count()
+                           << ", point loop " << stats.pointLoop.count()
+                           << ", setRouteLength " << stats.setRouteLength.count() << "." << std::endl;
+    }
+    report = reportStringStream.str();
+}
+
+Route::Route(std::string && source, bool isFileName, metres granularity, unsigned int threads){
     std::string gpsData;
-    std::string fileData;
-    std::vector<std::string> elements ={"gpx","rte"};
+    const std::vector<std::string> elements ={"gpx","rte"};
     this->granularity = granularity;
 
     if (isFileName){
-        fileData = readFileData(fileName);
-        reportStringStream << "Source file '" << fileName << "' opened okay." << std::endl;
+        LoadStats::PhaseTimer timer(stats.readFile);
+        gpsData = readFileData(source);
+        reportStringStream << "Source file '" << source << "' opened okay." << std::endl;
+    } else {
+        gpsData = std::move(source);
     }
+    stats.bytesScanned = gpsData.length();
 
-    gpsData = setupFileData(elements,fileData);
+    {
+        LoadStats::PhaseTimer timer(stats.setupFileData);
+        setupFileData(elements,gpsData);
+    }
 
     if (XML::Parser::elementExists(gpsData, "name")) {
         routeName = XML::Parser::getElementContent(XML::Parser::getAndEraseElement(gpsData, "name"));
         reportStringStream << "Route name is: " << routeName << std::endl;
     }
 
-    while (XML::Parser::elementExists(gpsData, "rtept")) {
-        newPostion = checkErrors(gpsData, "rtept");
-        addPostion(newPostion);
+    {
+        LoadStats::PhaseTimer timer(stats.pointLoop);
+        Trace::Span span("Route::pointLoop");
+        parsePoints(gpsData, "rtept", threads);
     }
+    std::string().swap(gpsData); // Release the GPX data before building the report.
 
-    reportStringStream << positions.size() << " positions added." << std::endl;
+    finishConstruction();
+}
+
+Route::Route(std::string_view source, bool isFileName, metres granularity, unsigned int threads)
+  : Route(std::string(source), isFileName, granularity, threads)
+{}
+
+Route::Route(const char * source, bool isFileName, metres granularity, unsigned int threads)
+  : Route(std::string(source), isFileName, granularity, threads)
+{}
+
+Route::Route(const std::vector<Position> & positions, const std::vector<std::string> & positionNames,
+             const std::string & name, metres granularity){
+    if (! positionNames.empty() && positionNames.size() != positions.size())
+        throw std::invalid_argument("There must be one name per Position, or none.");
+    this->granularity = granularity;
+
+    routeName = name;
+    if (! routeName.empty()) {
+        reportStringStream << "Route name is: " << routeName << std::endl;
+    }
+
+    {
+        LoadStats::PhaseTimer timer(stats.pointLoop);
+        Trace::Span span("Route::pointLoop");
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            if (appendPosition(positions[i])) {
+                this->positionNames.push_back(positionNames.empty() ? "" : positionNames[i]);
+            }
+        }
+    }
+
+    finishConstruction();
+}
+
+void Route::setGranularity(metres granularity)
+{
+    this->granularity = granularity;
+
+    std::vector<bool> kept(positions.size());
+    std::size_t lastKept = 0;
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        kept[i] = (i == 0) || ! areSameLocation(positions[i], positions[lastKept]);
+        if (kept[i]) lastKept = i;
+    }
+    const std::size_t numDiscarded = std::count(kept.begin(), kept.end(), false);
+    discardPositions(kept);
     setRouteLength();
+    invalidateCaches();
+
+    reportStringStream << "Granularity set to " << granularity << "m: "
+                       << numDiscarded << " positions discarded." << std::endl;
     report = reportStringStream.str();
+    if (rangeIndex) buildRangeIndex();
 }
 
-void Route::setGranularity(metres granularity)
+void Route::discardPositions(const std::vector<bool> & kept)
+{
+    std::size_t numKept = 0;
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        if (kept[i]) {
+            positions[numKept] = positions[i];
+            if (! positionNames.empty()) positionNames[numKept] = std::move(positionNames[i]);
+            ++numKept;
+        }
+    }
+    positions.erase(positions.begin() + numKept, positions.end());
+    if (! positionNames.empty()) positionNames.resize(numKept);
+}
+
+void Route::invalidateCaches()
+{
+    statisticsCache = std::make_unique<StatisticsCache>();
+}
+
+void Route::checkRange(unsigned int from, unsigned int to) const
 {
-    bool implemented = false;
-    assert(implemented);
+    if (to >= positions.size() || from > to) throw std::out_of_range("Invalid range of route points.");
 }
 
 bool Route::areSameLocation(const Position & p1, const Position & p2) const
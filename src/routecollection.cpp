@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include "routecollection.h"
+
+namespace GPS
+{
+  namespace
+  {
+      struct GPXFile
+      {
+          std::string fileName;
+          std::string path;
+          std::uintmax_t size;
+      };
+
+      // The ".gpx" files in the directory, in file name order.
+      std::vector<GPXFile> findGPXFiles(const std::string & directory)
+      {
+          std::error_code error;
+          std::filesystem::directory_iterator entries(directory, error);
+          if (error) throw std::invalid_argument("Cannot read directory '" + directory + "': " + error.message());
+
+          std::vector<GPXFile> files;
+          for (const std::filesystem::directory_entry & entry : entries)
+          {
+              if (! entry.is_regular_file(error) || entry.path().extension() != ".gpx") continue;
+              std::uintmax_t size = entry.file_size(error);
+              if (error) size = 0; // Its constructor will report the problem.
+              files.push_back({entry.path().filename().string(), entry.path().string(), size});
+          }
+          std::sort(files.begin(), files.end(),
+                    [] (const GPXFile & f1, const GPXFile & f2) { return f1.fileName < f2.fileName; });
+          return files;
+      }
+  }
+
+  template <typename T>
+  Collection<T> Collection<T>::loadDirectory(const std::string & directory, unsigned int threads)
+  {
+      const std::vector<GPXFile> files = findGPXFiles(directory);
+
+      // Largest first, so that the last files to be parsed are the quickest.
+      std::vector<std::size_t> schedule(files.size());
+      for (std::size_t i = 0; i < schedule.size(); ++i) schedule[i] = i;
+      std::stable_sort(schedule.begin(), schedule.end(),
+                       [&files] (std::size_t i, std::size_t j) { return files[i].size > files[j].size; });
+
+      // One slot per file, so threads never write to the same slot.
+      struct Slot
+      {
+          std::unique_ptr<T> item;
+          std::string error;
+      };
+      std::vector<Slot> slots(files.size());
+
+      std::atomic<std::size_t> nextIndex {0};
+      auto worker = [&] ()
+      {
+          for (std::size_t index = nextIndex++; index < schedule.size(); index = nextIndex++)
+          {
+              const std::size_t fileIndex = schedule[index];
+              const bool isFileName = true;
+              try
+              {
+                  slots[fileIndex].item = std::make_unique<T>(files[fileIndex].path, isFileName);
+              }
+              catch (const std::exception & e)
+              {
+                  slots[fileIndex].error = e.what();
+              }
+              catch (...)
+              {
+                  slots[fileIndex].error = "Unknown error.";
+              }
+          }
+      };
+
+      if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1U);
+      threads = static_cast<unsigned int>(std::max<std::size_t>(std::min<std::size_t>(threads, files.size()), 1));
+
+      std::vector<std::thread> pool;
+      for (unsigned int t = 1; t < threads; ++t) pool.emplace_back(worker);
+      worker();
+      for (std::thread & thread : pool) thread.join();
+
+      Collection collection;
+      for (std::size_t i = 0; i < files.size(); ++i)
+      {
+          if (slots[i].item)
+          {
+              collection.items.push_back(std::move(slots[i].item));
+              collection.fileNames.push_back(files[i].fileName);
+          }
+          else
+          {
+              collection.loadErrors.push_back({files[i].fileName, std::move(slots[i].error)});
+          }
+      }
+      return collection;
+  }
+
+  template <typename T>
+  std::size_t Collection<T>::size() const
+  {
+      return items.size();
+  }
+
+  template <typename T>
+  const T & Collection<T>::operator[](std::size_t index) const
+  {
+      return *items.at(index);
+  }
+
+  template <typename T>
+  const std::string & Collection<T>::fileName(std::size_t index) const
+  {
+      return fileNames.at(index);
+  }
+
+  template <typename T>
+  const std::vector<typename Collection<T>::LoadError> & Collection<T>::errors() const
+  {
+      return loadErrors;
+  }
+
+  template class Collection<Route>;
+  template class Collection<Track>;
+}
@@ -0,0 +1,96 @@
+#include <atomic>
+#include <stdexcept>
+
+#include "routesnapshot.h"
+
+namespace GPS
+{
+  namespace
+  {
+      RouteSnapshot::Statistics statisticsOf(const Route & route)
+      {
+          RouteSnapshot::Statistics stats;
+          stats.numPositions = route.numPositions();
+          stats.totalLength = route.totalLength();
+          stats.netLength = route.netLength();
+          stats.totalHeightGain = route.totalHeightGain();
+          stats.netHeightGain = route.netHeightGain();
+          stats.maxGradient = route.maxGradient();
+          stats.minGradient = route.minGradient();
+          stats.steepestGradient = route.steepestGradient();
+          stats.minLatitude = route.minLatitude();
+          stats.maxLatitude = route.maxLatitude();
+          stats.minLongitude = route.minLongitude();
+          stats.maxLongitude = route.maxLongitude();
+          stats.minElevation = route.minElevation();
+          stats.maxElevation = route.maxElevation();
+          return stats;
+      }
+  }
+
+  RouteSnapshot::RouteSnapshot(const std::vector<Position> & positions, const std::vector<std::string> & names,
+                               const std::string & name, metres granularity)
+    : snapshotRoute(positions, names, name, granularity),
+      stats{statisticsOf(snapshotRoute)}
+  {}
+
+  std::shared_ptr<const RouteSnapshot> RouteSnapshot::create(const std::vector<Position> & positions,
+                                                             const std::vector<std::string> & names,
+                                                             const std::string & name, metres granularity)
+  {
+      if (positions.empty()) throw std::domain_error("Cannot take a snapshot of an empty route.");
+      return std::shared_ptr<const RouteSnapshot>(new RouteSnapshot(positions, names, name, granularity));
+  }
+
+  std::shared_ptr<const RouteSnapshot> RouteSnapshot::of(const Route & route)
+  {
+      return create(route.positions, route.positionNames, route.routeName, route.granularity);
+  }
+
+  const RouteSnapshot::Statistics & RouteSnapshot::statistics() const
+  {
+      return stats;
+  }
+
+  const Route & RouteSnapshot::route() const
+  {
+      return snapshotRoute;
+  }
+
+  std::shared_ptr<const RouteSnapshot> RouteSnapshot::withPosition(const Position & position, const std::string & name) const
+  {
+      std::vector<Position> positions = snapshotRoute.positions;
+      std::vector<std::string> names = snapshotRoute.positionNames;
+      positions.push_back(position);
+      names.push_back(name);
+      return create(positions, names, snapshotRoute.routeName, snapshotRoute.granularity);
+  }
+
+  std::shared_ptr<const RouteSnapshot> RouteSnapshot::withGranularity(metres granularity) const
+  {
+      return create(snapshotRoute.positions, snapshotRoute.positionNames, snapshotRoute.routeName, granularity);
+  }
+
+  SharedRoute::SharedRoute(std::shared_ptr<const RouteSnapshot> initial)
+    : current{std::move(initial)}
+  {
+      if (! current) throw std::invalid_argument("A SharedRoute needs an initial snapshot.");
+  }
+
+  std::shared_ptr<const RouteSnapshot> SharedRoute::snapshot() const
+  {
+      return std::atomic_load(&current);
+  }
+
+  void SharedRoute::append(const Position & position, const std::string & name)
+  {
+      std::lock_guard<std::mutex> lock(updateMutex);
+      std::atomic_store(&current, std::atomic_load(&current)->withPosition(position, name));
+  }
+
+  void SharedRoute::setGranularity(metres granularity)
+  {
+      std::lock_guard<std::mutex> lock(updateMutex);
+      std::atomic_store(&current, std::atomic_load(&current)->withGranularity(granularity));
+  }
+}
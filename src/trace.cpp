@@ -0,0 +1,193 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "trace.h"
+
+namespace GPS
+{
+ namespace Trace
+ {
+  namespace
+  {
+      struct Event
+      {
+          const char * name;
+          std::int64_t start; // Nanoseconds since the process started.
+          std::int64_t duration;
+      };
+
+      /* Each thread appends to a chain of Chunks.  Only the owning thread writes; a Chunk's
+       * count is published (with release semantics) after each Event is written, so a
+       * concurrent reader only ever sees complete Events.
+       */
+      struct Chunk
+      {
+          static const std::size_t capacity = 4096;
+
+          Event events[capacity];
+          std::atomic<std::size_t> count {0};
+          std::atomic<Chunk *> next {nullptr};
+      };
+
+      struct ThreadBuffer
+      {
+          explicit ThreadBuffer(unsigned int tid) : tid{tid} {}
+          ~ThreadBuffer() { discardEvents(); }
+
+          void discardEvents()
+          {
+              Chunk * chunk = head.next.exchange(nullptr);
+              while (chunk != nullptr)
+              {
+                  Chunk * next = chunk->next.load();
+                  delete chunk;
+                  chunk = next;
+              }
+              head.count = 0;
+              tail = &head;
+          }
+
+          const unsigned int tid;
+          Chunk head;
+          Chunk * tail = &head; // Only accessed by the owning thread (or by clear()).
+      };
+
+      using Clock = std::chrono::steady_clock;
+
+      const Clock::time_point processStart = Clock::now();
+
+      [[maybe_unused]] std::int64_t now()
+      {
+          return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - processStart).count();
+      }
+
+      std::atomic<bool> recording {false};
+
+      // Buffers outlive their threads, so spans from finished worker threads can still be written.
+      std::mutex registryMutex;
+      std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+      thread_local ThreadBuffer * threadBuffer = nullptr;
+
+      ThreadBuffer & bufferForThisThread()
+      {
+          if (threadBuffer == nullptr)
+          {
+              std::lock_guard<std::mutex> lock(registryMutex);
+              registry.push_back(std::make_unique<ThreadBuffer>(static_cast<unsigned int>(registry.size())));
+              threadBuffer = registry.back().get();
+          }
+          return *threadBuffer;
+      }
+
+      [[maybe_unused]] void record(const char * name, std::int64_t start, std::int64_t duration)
+      {
+          ThreadBuffer & buffer = bufferForThisThread();
+          Chunk * chunk = buffer.tail;
+          std::size_t count = chunk->count.load(std::memory_order_relaxed);
+          if (count == Chunk::capacity)
+          {
+              Chunk * next = new Chunk;
+              chunk->next.store(next, std::memory_order_release);
+              buffer.tail = chunk = next;
+              count = 0;
+          }
+          chunk->events[count] = {name, start, duration};
+          chunk->count.store(count + 1, std::memory_order_release);
+      }
+
+      // Chrome trace timestamps are in microseconds.
+      void writeMicroseconds(std::ostream & output, std::int64_t nanoseconds)
+      {
+          char formatted[32];
+          std::snprintf(formatted, sizeof(formatted), "%lld.%03lld",
+                        static_cast<long long>(nanoseconds / 1000), static_cast<long long>(nanoseconds % 1000));
+          output << formatted;
+      }
+
+      void writeJSONString(std::ostream & output, const char * str)
+      {
+          output << '"';
+          for (; *str != '\0'; ++str)
+          {
+              if (*str == '"' || *str == '\\') output << '\\';
+              output << *str;
+          }
+          output << '"';
+      }
+  }
+
+  void enable(bool on)
+  {
+      recording = on && compiledIn;
+  }
+
+  bool enabled()
+  {
+      return recording;
+  }
+
+  std::size_t numEvents()
+  {
+      std::lock_guard<std::mutex> lock(registryMutex);
+      std::size_t total = 0;
+      for (const auto & buffer : registry)
+      {
+          for (const Chunk * chunk = &buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire))
+          {
+              total += chunk->count.load(std::memory_order_acquire);
+          }
+      }
+      return total;
+  }
+
+  void clear()
+  {
+      std::lock_guard<std::mutex> lock(registryMutex);
+      for (auto & buffer : registry) buffer->discardEvents();
+  }
+
+  void writeJSON(std::ostream & output)
+  {
+      std::lock_guard<std::mutex> lock(registryMutex);
+      output << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+      bool first = true;
+      for (const auto & buffer : registry)
+      {
+          for (const Chunk * chunk = &buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire))
+          {
+              const std::size_t count = chunk->count.load(std::memory_order_acquire);
+              for (std::size_t i = 0; i < count; ++i)
+              {
+                  const Event & event = chunk->events[i];
+                  output << (first ? "\n" : ",\n") << "{\"name\": ";
+                  writeJSONString(output, event.name);
+                  output << ", \"cat\": \"GPS\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->tid << ", \"ts\": ";
+                  writeMicroseconds(output, event.start);
+                  output << ", \"dur\": ";
+                  writeMicroseconds(output, event.duration);
+                  output << '}';
+                  first = false;
+              }
+          }
+      }
+      output << "\n]}\n";
+  }
+
+#ifdef GPS_TRACING
+  Span::Span(const char * name)
+    : name{recording.load(std::memory_order_relaxed) ? name : nullptr},
+      start{this->name != nullptr ? now() : 0}
+  {}
+
+  Span::~Span()
+  {
+      if (name != nullptr) record(name, start, now() - start);
+  }
+#endif
+ }
+}
@@ -4,13 +4,27 @@
 #include <cassert>
 #include <cmath>
 #include <stdexcept>
+#include <algorithm>
 
 #include "geometry.h"
 #include "xmlparser.h"
 #include "track.h"
+#include "trace.h"
 
 using namespace GPS;
 
+namespace
+{
+    // The Position a fraction of the way from p1 to p2, taking the shorter way around in longitude.
+    Position interpolate(const Position & p1, const Position & p2, double fraction)
+    {
+        degrees lat = p1.latitude() + fraction * (p2.latitude() - p1.latitude());
+        degrees lon = normaliseDeg(p1.longitude() + fraction * normaliseDeg(p2.longitude() - p1.longitude()));
+        metres ele = p1.elevation() + fraction * (p2.elevation() - p1.elevation());
+        return Position(lat, lon, ele);
+    }
+}
+
 // Note: The implementation should exploit the relationship:
 //   totalTime() == restingTime() + travellingTime()
 
@@ -22,13 +36,17 @@ seconds Track::totalTime() const
 
 seconds Track::restingTime() const
 {
-    seconds total = 0;
-    assert (arrived.size() == departed.size());
-    for (unsigned int i = 0; i < arrived.size(); ++i)
+    return trackStatisticsCache->restingTime.get([this] () -> seconds
     {
-        total += departed[i] - arrived[i];
-    }
-    return total;
+        Trace::Span span("Track::restingTime");
+        seconds total = 0;
+        assert (arrived.size() == departed.size());
+        for (unsigned int i = 0; i < arrived.size(); ++i)
+        {
+            total += departed[i] - arrived[i];
+        }
+        return total;
+    });
 }
 
 seconds Track::travellingTime() const
@@ -36,21 +54,53 @@ seconds Track::travellingTime() const
     return totalTime() - restingTime();
 }
 
-speed Track::maxSpeed() const
+seconds Track::totalTime(unsigned int from, unsigned int to) const
 {
-    assert( positions.size() == departed.size() && positions.size() == arrived.size() );
-    if (positions.size() == 1) return 0.0;
+    checkRange(from, to);
+    return departed[to] - arrived[from];
+}
+
+seconds Track::travellingTime(unsigned int from, unsigned int to) const
+{
+    return totalTime(from, to) - restingTime(from, to);
+}
 
-    speed ms = 0;
-    for (unsigned int i = 1; i < positions.size(); ++i)
+seconds Track::restingTime(unsigned int from, unsigned int to) const
+{
+    checkRange(from, to);
+    const std::vector<seconds> & prefixSums = trackStatisticsCache->restingTimePrefixSums.get([this] ()
     {
-        metres deltaH = Position::distanceBetween(positions[i],positions[i-1]);
-        metres deltaV = positions[i].elevation() - positions[i-1].elevation();
-        metres distance = std::sqrt(std::pow(deltaH,2) + std::pow(deltaV,2));
-        seconds time = arrived[i] - departed[i-1];
-        ms = std::max(ms,distance/time);
-    }
-    return ms;
+        Trace::Span span("Track::restingTimePrefixSums");
+        assert (arrived.size() == departed.size());
+        std::vector<seconds> sums(arrived.size() + 1);
+        for (unsigned int i = 0; i < arrived.size(); ++i)
+        {
+            sums[i+1] = sums[i] + (departed[i] - arrived[i]);
+        }
+        return sums;
+    });
+    return prefixSums[to + 1] - prefixSums[from];
+}
+
+speed Track::maxSpeed() const
+{
+    return trackStatisticsCache->maxSpeed.get([this] () -> speed
+    {
+        Trace::Span span("Track::maxSpeed");
+        assert( positions.size() == departed.size() && positions.size() == arrived.size() );
+        if (positions.size() == 1) return 0.0;
+
+        speed ms = 0;
+        for (unsigned int i = 1; i < positions.size(); ++i)
+        {
+            metres deltaH = Position::distanceBetween(positions[i],positions[i-1]);
+            metres deltaV = positions[i].elevation() - positions[i-1].elevation();
+            metres distance = std::sqrt(std::pow(deltaH,2) + std::pow(deltaV,2));
+            seconds time = arrived[i] - departed[i-1];
+            ms = std::max(ms,distance/time);
+        }
+        return ms;
+    });
 }
 
 speed Track::averageSpeed(bool includeRests) const
@@ -62,38 +112,153 @@ speed Track::averageSpeed(bool includeRests) const
 
 speed Track::maxRateOfAscent() const
 {
-    assert( positions.size() == departed.size() && positions.size() == arrived.size() );
-    if (positions.size() == 1) return 0.0;
+    return trackStatisticsCache->maxRateOfAscent.get([this] () -> speed
+    {
+        Trace::Span span("Track::maxRateOfAscent");
+        assert( positions.size() == departed.size() && positions.size() == arrived.size() );
+        if (positions.size() == 1) return 0.0;
 
-    speed ms = 0;
-    for (unsigned int i = 1; i < positions.size(); ++i)
+        speed ms = 0;
+        for (unsigned int i = 1; i < positions.size(); ++i)
+        {
+            metres height = positions[i].elevation() - positions[i-1].elevation();
+            seconds time = arrived[i] - departed[i-1];
+            ms = std::max(ms,height/time);
+        }
+        return ms;
+    });
+}
+
+speed Track::maxRateOfDescent() const
+{
+    return trackStatisticsCache->maxRateOfDescent.get([this] () -> speed
+    {
+        Trace::Span span("Track::maxRateOfDescent");
+        assert( positions.size() == departed.size() && positions.size() == arrived.size() );
+        if (positions.size() == 1) return 0.0;
+
+        speed ms = 0;
+        for (unsigned int i = 1; i < positions.size(); ++i)
+        {
+            metres height = positions[i-1].elevation() - positions[i].elevation();
+            seconds time = arrived[i] - departed[i-1];
+            ms = std::max(ms,height/time);
+        }
+        return ms;
+    });
+}
+
+Position Track::positionAt(seconds time) const
+{
+    if (positions.empty() || time < arrived.front() || time > departed.back())
+        throw std::out_of_range("The Track has no position at that time.");
+
+    const std::size_t i = std::upper_bound(arrived.begin(), arrived.end(), time) - arrived.begin() - 1;
+    return positionAfterArriving(time, i);
+}
+
+std::vector<Position> Track::positionsAt(const std::vector<seconds> & times) const
+{
+    std::vector<Position> result;
+    result.reserve(times.size());
+    std::size_t i = 0;
+    for (std::size_t t = 0; t < times.size(); ++t)
     {
-        metres height = positions[i].elevation() - positions[i-1].elevation();
-        seconds time = arrived[i] - departed[i-1];
-        ms = std::max(ms,height/time);
+        if (t > 0 && times[t] < times[t-1])
+            throw std::invalid_argument("The times must be in increasing order.");
+        if (positions.empty() || times[t] < arrived.front() || times[t] > departed.back())
+            throw std::out_of_range("The Track has no position at that time.");
+
+        while (i + 1 < arrived.size() && arrived[i+1] <= times[t]) ++i;
+        result.push_back(positionAfterArriving(times[t], i));
     }
-    return ms;
+    return result;
 }
 
-speed Track::maxRateOfDescent() const
+Position Track::positionAfterArriving(seconds time, std::size_t i) const
+{
+    if (time <= departed[i]) return positions[i];
+
+    // Travelling, so there is a next point, arrived at after "time".
+    const double fraction = static_cast<double>(time - departed[i]) / (arrived[i+1] - departed[i]);
+    return interpolate(positions[i], positions[i+1], fraction);
+}
+
+Track Track::resampled(seconds interval) const
 {
-    assert( positions.size() == departed.size() && positions.size() == arrived.size() );
-    if (positions.size() == 1) return 0.0;
+    if (interval == 0) throw std::invalid_argument("The resampling interval must be positive.");
+
+    Track track;
+    track.granularity = 0;
+    track.routeName = routeName;
+    if (! routeName.empty()) {
+        track.reportStringStream << "Track name is: " << routeName << std::endl;
+    }
+    track.reportStringStream << "Resampled every " << interval << " seconds." << std::endl;
 
-    speed ms = 0;
-    for (unsigned int i = 1; i < positions.size(); ++i)
     {
-        metres height = positions[i-1].elevation() - positions[i].elevation();
-        seconds time = arrived[i] - departed[i-1];
-        ms = std::max(ms,height/time);
+        LoadStats::PhaseTimer timer(track.stats.pointLoop);
+        Trace::Span span("Track::resampled");
+        if (! positions.empty()) {
+            const std::size_t numSamples = (departed.back() - arrived.front()) / interval + 1;
+            track.positions.reserve(numSamples);
+            track.positionNames.reserve(numSamples);
+            track.arrived.reserve(numSamples);
+            track.departed.reserve(numSamples);
+
+            std::size_t i = 0;
+            for (seconds time = arrived.front(); time <= departed.back(); time += interval) {
+                while (i + 1 < arrived.size() && arrived[i+1] <= time) ++i;
+                track.appendPosition(positionAfterArriving(time, i), time);
+                track.positionNames.push_back("");
+            }
+        }
+    }
+
+    track.finishConstruction();
+    return track;
+}
+
+MemoryUsage Track::memoryUsage() const
+{
+    MemoryUsage usage = Route::memoryUsage();
+    usage.object += sizeof(Track) - sizeof(Route);
+    usage.times = (arrived.capacity() + departed.capacity()) * sizeof(seconds);
+    usage.caches += sizeof(TrackStatisticsCache);
+    if (trackStatisticsCache->restingTimePrefixSums.ifComputed()) {
+        usage.caches += trackStatisticsCache->restingTimePrefixSums.ifComputed()->capacity() * sizeof(seconds);
     }
-    return ms;
+    return usage;
 }
 
 void Track::setGranularity(metres granularity)
 {
-    bool implemented = false;
-    assert(implemented);
+    // The filtering is the Route's; the times are merged by discardPositions().
+    Route::setGranularity(granularity);
+}
+
+void Track::discardPositions(const std::vector<bool> & kept)
+{
+    // The time spent at a discarded Position, and travelling to it, becomes time spent at the last kept one.
+    std::size_t numKept = 0;
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        if (kept[i]) {
+            arrived[numKept] = arrived[i];
+            departed[numKept] = departed[i];
+            ++numKept;
+        } else {
+            departed[numKept - 1] = departed[i];
+        }
+    }
+    arrived.resize(numKept);
+    departed.resize(numKept);
+    Route::discardPositions(kept);
+}
+
+void Track::invalidateCaches()
+{
+    Route::invalidateCaches();
+    trackStatisticsCache = std::make_unique<TrackStatisticsCache>();
 }
 
 seconds Track::stringToTime(const std::string & timeStr)
@@ -101,57 +266,105 @@ seconds Track::stringToTime(const std::string & timeStr)
     return stoull(timeStr);
 }
 
-seconds Track::getTime(std::string newPostion){
+seconds Track::getTime(std::string_view newPostion){
     if (! XML::Parser::elementExists(newPostion,"time"))
         throw std::domain_error("No 'time' element.");
 
     return stringToTime(XML::Parser::getElementContent(XML::Parser::getElement(newPostion,"time")));
 }
 
-void Track::addPostion(std::string newPostion){
-    positions.push_back(getNewPostion(newPostion));
-    seconds currentTime = getTime(newPostion);
-    if (positions.size()>1 && areSameLocation(positions.back(), positions.at(positions.size()-2))) {
-        // If we're still at the same location, then we haven't departed yet.
-        departed.back() = currentTime;
-        reportStringStream << "Position ignored: " << positions.back().toString() << std::endl;
-        positions.pop_back();
-    } else {
-        positionNames.push_back(getName(newPostion));
+bool Track::appendPosition(const Position & position, seconds currentTime){
+    const bool kept = positions.empty() || ! areSameLocation(position, positions.back());
+    reportPosition(reportStringStream, position, currentTime, kept);
+    storePosition(position, currentTime, kept);
+    return kept;
+}
+
+Route::ParsedPoint Track::parsePoint(const std::string & element){
+    Position position = getNewPostion(element);
+    seconds time = getTime(element);
+    return {position, time, getName(element)};
+}
+
+void Track::reportPosition(std::ostream & report, const Position & position, seconds currentTime, bool kept) const{
+    Route::reportPosition(report, position, currentTime, kept);
+    if (kept) report << " at time: " << currentTime << '\n';
+}
+
+void Track::storePosition(const Position & position, seconds currentTime, bool kept){
+    Route::storePosition(position, currentTime, kept);
+    if (kept) {
         arrived.push_back(currentTime);
         departed.push_back(currentTime);
-        reportStringStream << "Position added: " << positions.back().toString() << std::endl;
-        reportStringStream << " at time: " << std::to_string(currentTime) << std::endl;
+    } else {
+        // If we're still at the same location, then we haven't departed yet.
+        departed.back() = currentTime;
     }
 }
 
-Track::Track(std::string fileName, bool isFileName, metres granularity){
-    std::string newPostion;
+Track::Track(std::string && source, bool isFileName, metres granularity, unsigned int threads){
     std::string gpsData;
-    std::string fileData;
-    std::vector<std::string> elements = {"gpx", "trk"};
+    const std::vector<std::string> elements = {"gpx", "trk"};
     this->granularity = granularity;
 
     if (isFileName){
-        fileData = readFileData(fileName);
-        reportStringStream << "Source file '" << fileName << "' opened okay." << std::endl;
+        LoadStats::PhaseTimer timer(stats.readFile);
+        gpsData = readFileData(source);
+        reportStringStream << "Source file '" << source << "' opened okay." << std::endl;
+    } else {
+        gpsData = std::move(source);
     }
+    stats.bytesScanned = gpsData.length();
 
-    gpsData = setupFileData(elements,fileData);
+    {
+        LoadStats::PhaseTimer timer(stats.setupFileData);
+        setupFileData(elements,gpsData);
+    }
 
     if (XML::Parser::elementExists(gpsData, "name")) {
         routeName = XML::Parser::getElementContent(XML::Parser::getAndEraseElement(gpsData, "name"));
         reportStringStream << "Track name is: " << routeName << std::endl;
     }
 
-    while (XML::Parser::elementExists(gpsData, "trkpt")) {
-        newPostion = checkErrors(gpsData, "trkpt");
-        addPostion(newPostion);
+    {
+        LoadStats::PhaseTimer timer(stats.pointLoop);
+        Trace::Span span("Track::pointLoop");
+        parsePoints(gpsData, "trkpt", threads);
+    }
+    std::string().swap(gpsData); // Release the GPX data before building the report.
+    finishConstruction();
+}
+
+Track::Track(std::string_view source, bool isFileName, metres granularity, unsigned int threads)
+  : Track(std::string(source), isFileName, granularity, threads)
+{}
+
+Track::Track(const char * source, bool isFileName, metres granularity, unsigned int threads)
+  : Track(std::string(source), isFileName, granularity, threads)
+{}
+
+Track::Track(const std::vector<Position> & positions, const std::vector<seconds> & times,
+             const std::string & name, metres granularity){
+    if (times.size() != positions.size())
+        throw std::invalid_argument("There must be one time per Position.");
+    this->granularity = granularity;
+
+    routeName = name;
+    if (! routeName.empty()) {
+        reportStringStream << "Track name is: " << routeName << std::endl;
+    }
 
+    {
+        LoadStats::PhaseTimer timer(stats.pointLoop);
+        Trace::Span span("Track::pointLoop");
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            if (appendPosition(positions[i], times[i])) {
+                positionNames.push_back("");
+            }
+        }
     }
-    reportStringStream << positions.size() << " positions added." << std::endl;
-    setRouteLength();
-    report = reportStringStream.str();
+
+    finishConstruction();
 }
 
 
@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "workload.h"
+
+using namespace GPS;
+
+/* Generates a reproducible corpus of GPX or NMEA files for performance testing.
+ *
+ * Usage: workload-generator <directory> <total MB> [seed] [gpx|nmea] [file MB] [threads]
+ */
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <directory> <total MB> [seed] [gpx|nmea] [file MB] [threads]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        const std::size_t megabyte = 1 << 20;
+        const std::string directory = argv[1];
+        const std::size_t totalSize = static_cast<std::size_t>(std::stod(argv[2]) * megabyte);
+
+        Workload::Options options;
+        if (argc > 3) options.seed = std::stoull(argv[3]);
+        if (argc > 4)
+        {
+            const std::string format = argv[4];
+            if (format == "gpx") options.format = Workload::Format::GPX;
+            else if (format == "nmea") options.format = Workload::Format::NMEA;
+            else throw std::invalid_argument("Unknown format '" + format + "'.");
+        }
+        if (argc > 5) options.fileSize = static_cast<std::size_t>(std::stod(argv[5]) * megabyte);
+        const unsigned int threads = (argc > 6) ? static_cast<unsigned int>(std::stoul(argv[6])) : 0;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const std::size_t numFiles = Workload::generateCorpus(options, directory, totalSize, threads).size();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Generated " << numFiles << " files in " << elapsed.count() << " s" << std::endl;
+    }
+    catch (const std::exception & e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
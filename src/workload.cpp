@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "earth.h"
+#include "xmlgenerator.h"
+#include "workload.h"
+
+namespace GPS
+{
+ namespace Workload
+ {
+  namespace
+  {
+      /* SplitMix64.  The standard library distributions are not specified exactly, so
+       * would not give the same corpus on every platform; this is, and is cheap to seed.
+       */
+      class Random
+      {
+        public:
+          Random(std::uint64_t seed) : state{seed} {}
+
+          std::uint64_t next()
+          {
+              std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+              z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+              z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+              return z ^ (z >> 31);
+          }
+
+          // Uniform in [0,1).
+          double unit()
+          {
+              return static_cast<double>(next() >> 11) * 0x1.0p-53;
+          }
+
+          // Uniform in [low,high).
+          double between(double low, double high)
+          {
+              return low + unit() * (high - low);
+          }
+
+          // Uniform in [1,max].
+          unsigned int upTo(unsigned int max)
+          {
+              return 1 + static_cast<unsigned int>(next() % std::max(max, 1U));
+          }
+
+        private:
+          std::uint64_t state;
+      };
+
+      // Independent streams for each file, and for each part (GridWorld, walk, start time) of a file.
+      Random randomFor(const Options & options, std::size_t index, std::uint64_t stream)
+      {
+          Random mix(options.seed ^ (0xD1B54A32D192ED03ULL * (index + 1)) ^ (stream << 56));
+          return Random(mix.next());
+      }
+
+      const std::uint64_t gridWorldStream = 1;
+      const std::uint64_t walkStream = 2;
+      const std::uint64_t startTimeStream = 3;
+
+      // Approximate output size of each logged point, used to decide how long each walk should be.
+      std::size_t bytesPerPoint(Format format)
+      {
+          return (format == Format::GPX) ? 168 : 180;
+      }
+
+      // 2020-01-01T00:00:00Z
+      const seconds earliestStartTime = 1577836800;
+      const seconds startTimeRange = 365 * 24 * 60 * 60;
+  }
+
+  GridWorld gridWorldFor(const Options & options, std::size_t index)
+  {
+      Random random = randomFor(options, index, gridWorldStream);
+
+      const degrees lat = random.between(-60, 60);
+      const degrees lon = options.crossAntimeridian ? 180 : random.between(-180, 180);
+      const metres ele = random.between(0, 2000);
+
+      GridWorld gridworld(options.gridSize, options.gridSize, Position(lat, lon, ele),
+                          options.horizontalGridUnit, options.verticalGridUnit);
+
+      if (options.elevationNoise > 0)
+      {
+          for (unsigned int row = 0; row < gridworld.rows(); ++row)
+          {
+              for (unsigned int column = 0; column < gridworld.columns(); ++column)
+              {
+                  const GridWorld::Coordinates coords {row, column};
+                  gridworld.setElevation(coords, gridworld[coords].elevation()
+                                                 + random.between(-options.elevationNoise, options.elevationNoise));
+              }
+          }
+      }
+      return gridworld;
+  }
+
+  std::string trackStringFor(const Options & options, std::size_t index)
+  {
+      Random random = randomFor(options, index, walkStream);
+
+      const std::size_t targetPoints = std::max<std::size_t>(options.fileSize / bytesPerPoint(options.format), 1);
+      const int lastRowOrColumn = static_cast<int>(options.gridSize) - 1;
+
+      auto appendPoint = [] (std::string & track, int row, int column)
+      {
+          track += '(';
+          track += std::to_string(row);
+          track += ',';
+          track += std::to_string(column);
+          track += ')';
+      };
+
+      int row = static_cast<int>(options.gridSize / 2);
+      int column = row;
+      std::string track;
+      appendPoint(track, row, column);
+
+      std::size_t points = 0;
+      while (points < targetPoints)
+      {
+          const double choice = random.unit();
+          unsigned int timeUnits;
+          if (choice < options.duplicateProbability)
+          {
+              timeUnits = 0;
+          }
+          else if (choice < options.duplicateProbability + options.restProbability)
+          {
+              timeUnits = random.upTo(options.maxRestTimeUnits);
+          }
+          else
+          {
+              // Move to one of the 8 neighbouring points, turning back at the edges of the grid.
+              int step;
+              do step = static_cast<int>(random.next() % 9); while (step == 4);
+              const int rowStep = step / 3 - 1;
+              const int columnStep = step % 3 - 1;
+              row += (row + rowStep < 0 || row + rowStep > lastRowOrColumn) ? -rowStep : rowStep;
+              column += (column + columnStep < 0 || column + columnStep > lastRowOrColumn) ? -columnStep : columnStep;
+              timeUnits = random.upTo(options.maxTimeUnitsPerStep);
+          }
+
+          track += std::to_string(timeUnits);
+          appendPoint(track, row, column);
+          points += (timeUnits * options.timeUnitDuration) / options.logInterval + 1;
+      }
+      return track;
+  }
+
+  GridWorldTrack trackFor(const Options & options, std::size_t index)
+  {
+      Random random = randomFor(options, index, startTimeStream);
+      const seconds startTime = earliestStartTime + random.next() % startTimeRange;
+      return GridWorldTrack(trackStringFor(options, index), options.timeUnitDuration, startTime,
+                            gridWorldFor(options, index));
+  }
+
+  std::string fileNameFor(const Options & options, std::size_t index)
+  {
+      std::string number = std::to_string(index);
+      if (number.length() < 4) number.insert(0, 4 - number.length(), '0');
+      return "workload-" + number + (options.format == Format::GPX ? ".gpx" : ".log");
+  }
+
+  void writeFile(const Options & options, std::size_t index, int fileDescriptor)
+  {
+      const GridWorldTrack track = trackFor(options, index);
+      if (options.format == Format::GPX)
+      {
+          track.toGPX(XML::Generator::fileDescriptorSink(fileDescriptor), options.logInterval);
+      }
+      else
+      {
+          track.toNMEA(options.logInterval, fileDescriptor);
+      }
+  }
+
+  std::vector<std::string> generateCorpus(const Options & options, const std::string & directory,
+                                          std::size_t totalSize, unsigned int threads)
+  {
+      if (options.fileSize == 0) throw std::invalid_argument("The file size of a workload must be non-zero.");
+
+      const std::size_t numFiles = (totalSize + options.fileSize - 1) / options.fileSize;
+      std::vector<std::string> paths;
+      paths.reserve(numFiles);
+      for (std::size_t index = 0; index < numFiles; ++index)
+      {
+          paths.push_back(directory + "/" + fileNameFor(options, index));
+      }
+
+      if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1U);
+      threads = static_cast<unsigned int>(std::min<std::size_t>(threads, numFiles));
+
+      std::atomic<std::size_t> nextIndex {0};
+      std::exception_ptr firstError;
+      std::mutex errorMutex;
+
+      auto worker = [&] ()
+      {
+          for (std::size_t index = nextIndex++; index < numFiles; index = nextIndex++)
+          {
+              try
+              {
+                  int fileDescriptor = ::open(paths[index].c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                  if (fileDescriptor < 0) throw std::runtime_error("Cannot open '" + paths[index] + "' for writing.");
+                  try
+                  {
+                      writeFile(options, index, fileDescriptor);
+                  }
+                  catch (...)
+                  {
+                      ::close(fileDescriptor);
+                      throw;
+                  }
+                  if (::close(fileDescriptor) != 0) throw std::runtime_error("Error writing '" + paths[index] + "'.");
+              }
+              catch (...)
+              {
+                  std::lock_guard<std::mutex> lock(errorMutex);
+                  if (! firstError) firstError = std::current_exception();
+                  nextIndex = numFiles; // Abandon the remaining files.
+                  return;
+              }
+          }
+      };
+
+      std::vector<std::thread> pool;
+      for (unsigned int t = 1; t < threads; ++t) pool.emplace_back(worker);
+      worker();
+      for (std::thread & thread : pool) thread.join();
+
+      if (firstError) std::rethrow_exception(firstError);
+      return paths;
+  }
+ }
+}
@@ -1,90 +1,223 @@
+#include <algorithm>
+#include <charconv>
 #include <stdexcept>
 #include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
 
 #include "xmlgenerator.h"
 
 namespace XML
 {
-  Generator::Generator(unsigned int indentationSpaces) : indentationSpaces{indentationSpaces} {}
+  Generator::Sink Generator::fileDescriptorSink(int fileDescriptor)
+  {
+      return [fileDescriptor] (const char * data, std::size_t length)
+      {
+          while (length > 0)
+          {
+              ssize_t written = ::write(fileDescriptor, data, length);
+              if (written < 0)
+              {
+                  if (errno == EINTR) continue;
+                  throw std::runtime_error("Error writing XML to file descriptor.");
+              }
+              data += written;
+              length -= static_cast<std::size_t>(written);
+          }
+      };
+  }
+
+  Generator::Sink Generator::stringSink(std::string & destination)
+  {
+      return [&destination] (const char * data, std::size_t length)
+      {
+          destination.append(data, length);
+      };
+  }
+
+  Generator::Generator(unsigned int indentationSpaces, bool compact)
+    : indentationSpaces{indentationSpaces},
+      compact{compact}
+  {}
+
+  Generator::Generator(Sink sink, unsigned int indentationSpaces, bool compact)
+    : sink{std::move(sink)},
+      indentationSpaces{indentationSpaces},
+      compact{compact}
+  {}
+
+  Generator::Generator(unsigned int indentationSpaces, bool compact, unsigned int baseIndentationLevel)
+    : indentationSpaces{indentationSpaces},
+      baseIndentationLevel{baseIndentationLevel},
+      compact{compact}
+  {}
+
+  Generator::~Generator()
+  {
+      try
+      {
+          flush();
+      }
+      catch (...) {} // Destructors must not throw.
+  }
 
   void Generator::basicXMLDeclaration()
   {
-      xml << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\" standalone=\"yes\"?>";
+      write("<?xml version=\"1.0\" encoding=\"ISO-8859-1\" standalone=\"yes\"?>");
       newline();
   }
 
   void Generator::openBasicGPXElement()
   {
-      std::string gpxAttributes = "version=\"1.1\" creator=\"NTU\" xmlns=\"http://www.topografix.com/GPX/1/1\" xmlns:xsd=\"http://www.w3.org/2001/XMLSchema\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xsi:schemaLocation=\"http://www.topografix.com/GPX/1/1 http://www.topografix.com/GPX/1/1/gpx.xsd\"";
+      const char * gpxAttributes = "version=\"1.1\" creator=\"NTU\" xmlns=\"http://www.topografix.com/GPX/1/1\" xmlns:xsd=\"http://www.w3.org/2001/XMLSchema\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xsi:schemaLocation=\"http://www.topografix.com/GPX/1/1 http://www.topografix.com/GPX/1/1/gpx.xsd\"";
       openElement("gpx",gpxAttributes);
   }
 
-  void Generator::element(const std::string& name, const std::string& attributes, const std::string& content)
+  void Generator::element(std::string_view name, std::string_view attributes, std::string_view content)
   {
       indent();
       openingTag(name,attributes);
-      xml << content;
+      write(content);
       closingTag(name);
       newline();
   }
 
-  void Generator::openElement(const std::string& name, const std::string& attributes)
+  void Generator::element(std::string_view name, std::string_view attributes, double content)
+  {
+      const int decimalPlaces = 6;
+      char number[328]; // Large enough for any double in fixed notation.
+      element(name, attributes, std::string_view(number, std::to_chars(number, number + sizeof(number), content,
+                                                                       std::chars_format::fixed, decimalPlaces).ptr - number));
+  }
+
+  void Generator::element(std::string_view name, std::string_view attributes, unsigned long long content)
+  {
+      char number[24];
+      element(name, attributes, std::string_view(number, std::to_chars(number, number + sizeof(number), content).ptr - number));
+  }
+
+  void Generator::openElement(std::string_view name, std::string_view attributes)
   {
+      if (indentationLevel == maxDepth) throw std::domain_error("XML elements nested too deeply.");
       indent();
       openingTag(name,attributes);
-      unclosedTags.push(name);
+      unclosedTags[indentationLevel] = name;
       ++indentationLevel;
       newline();
   }
 
   void Generator::closeElement()
   {
-      if (unclosedTags.empty()) throw std::domain_error("No XML element to close.");
+      if (indentationLevel == 0) throw std::domain_error("No XML element to close.");
       --indentationLevel;
       indent();
-      closingTag(unclosedTags.top());
-      unclosedTags.pop();
+      closingTag(unclosedTags[indentationLevel]);
       newline();
   }
 
   void Generator::closeAllElements()
   {
-      while (! unclosedTags.empty())
+      while (indentationLevel > 0)
       {
-          --indentationLevel;
-          indent();
-          closingTag(unclosedTags.top());
-          unclosedTags.pop();
-          newline();
+          closeElement();
       }
   }
 
+  void Generator::flush()
+  {
+      if (buffered == 0) return;
+      std::size_t length = buffered;
+      buffered = 0;
+      sink(buffer, length);
+  }
+
+  Generator Generator::fragment() const
+  {
+      return Generator(indentationSpaces, compact, baseIndentationLevel + indentationLevel);
+  }
+
+  void Generator::insert(std::string_view xml)
+  {
+      write(xml);
+  }
+
   std::string Generator::closeAllElementsAndExtractString()
   {
+      if (sink) throw std::domain_error("XML has been written to a Sink, so cannot be extracted.");
       closeAllElements();
-      return xml.str();
+      return std::move(xml);
+  }
+
+  void Generator::write(const char * data, std::size_t length)
+  {
+      if (! sink)
+      {
+          xml.append(data, length);
+          return;
+      }
+
+      if (buffered + length > bufferSize)
+      {
+          flush();
+          if (length > bufferSize)
+          {   // Too large to buffer, so pass straight through.
+              sink(data, length);
+              return;
+          }
+      }
+      std::memcpy(buffer + buffered, data, length);
+      buffered += length;
   }
 
-  void Generator::openingTag(const std::string& name, const std::string& attributes)
+  void Generator::write(std::string_view str)
   {
-      xml << '<' << name;
+      write(str.data(), str.length());
+  }
+
+  void Generator::write(char c)
+  {
+      write(&c, 1);
+  }
+
+  void Generator::openingTag(std::string_view name, std::string_view attributes)
+  {
+      write('<');
+      write(name);
       if (! attributes.empty())
-          xml << ' ' << attributes;
-      xml << '>';
+      {
+          write(' ');
+          write(attributes);
+      }
+      write('>');
   }
 
-  void Generator::closingTag(const std::string& name)
+  void Generator::closingTag(std::string_view name)
   {
-      xml << "</" << name << '>';
+      write("</", 2);
+      write(name);
+      write('>');
   }
 
   void Generator::indent()
   {
-      xml << std::string(indentationLevel*indentationSpaces,' ');
+      if (compact) return;
+
+      // Indentation is written in slices of a static run of spaces, rather than building a string.
+      static const char spaces[] = "                                                                ";
+      const std::size_t sliceLength = sizeof(spaces) - 1;
+
+      std::size_t remaining = (baseIndentationLevel + indentationLevel) * indentationSpaces;
+      while (remaining > 0)
+      {
+          std::size_t slice = std::min(remaining, sliceLength);
+          write(spaces, slice);
+          remaining -= slice;
+      }
   }
 
   void Generator::newline()
   {
-      xml << std::endl;
+      if (! compact) write('\n');
   }
 }
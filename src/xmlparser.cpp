@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
@@ -8,28 +9,28 @@ namespace XML
  namespace Parser
  {
    using std::string;
+   using std::string_view;
 
   /* The convention for variable names in this file is for "Begin" to be the index of the
    * first character of the item, and for "End" to be the index of the first character after
    * the item.
    */
 
-  std::pair<size_t,size_t> findElement(const string & source, const string & elementName)
-  /* Returns the a pair containing <index,length> where index is the index of the start
-   * of the element, and length is the length of the element.
-   *
-   * Note: the current implementation does not handle:
+  std::pair<size_t,size_t> findElement(string_view source, string_view elementName)
+  /* Note: the current implementation does not handle:
    *  * nested elements with the same name;
    *  * escape characters;
    *  * ">" symbols within strings.
    */
   {
+      const string openingTag = "<" + string(elementName);
+      const string closingTag = "</" + string(elementName) + ">";
       size_t openingTagBegin;
 
       size_t current = 0;
       do
       {
-          openingTagBegin = source.find("<" + elementName, current);
+          openingTagBegin = source.find(openingTag, current);
           current = openingTagBegin + elementName.length() + 1;
           if (openingTagBegin == string::npos || current >= source.length())
           {
@@ -49,7 +50,7 @@ namespace XML
           return {openingTagBegin, openingTagEnd-openingTagBegin};
       }
 
-      size_t closingTagBegin = source.find("</" + elementName + ">", openingTagEnd);
+      size_t closingTagBegin = source.find(closingTag, openingTagEnd);
       if (closingTagBegin == string::npos)
       {
           return {string::npos, 0};
@@ -58,19 +59,19 @@ namespace XML
       return {openingTagBegin, closingTagEnd-openingTagBegin};
   }
 
-  bool elementExists(const string & source, const string & elementName)
+  bool elementExists(string_view source, string_view elementName)
   {
       return findElement(source,elementName).first != string::npos;
   }
 
-  string getElement(const string & source, const string & elementName)
+  string getElement(string_view source, string_view elementName)
   {
       assert( elementExists(source,elementName) );
       std::pair<size_t,size_t> p = findElement(source, elementName);
-      return source.substr(p.first, p.second);
+      return string(source.substr(p.first, p.second));
   }
 
-  string getAndEraseElement(string & source, const string & elementName)
+  string getAndEraseElement(string & source, string_view elementName)
   {
       assert( elementExists(source,elementName) );
       std::pair<size_t,size_t> p = findElement(source, elementName);
@@ -79,26 +80,68 @@ namespace XML
       return element;
   }
 
-  string getElementContent(const string & element)
+  namespace
   {
-      assert(element.front() == '<');
-      assert(element.back()  == '>');
+      // The <index,length> of the content of an element, within the element.
+      std::pair<size_t,size_t> findContent(string_view element)
+      {
+          assert(element.front() == '<');
+          assert(element.back()  == '>');
 
-      size_t openingTagEnd = element.find(">") + 1;
+          size_t openingTagEnd = element.find(">") + 1;
+
+          if (element[openingTagEnd - 2] == '/')
+          {   // Has form <tagName ... /> so no content.
+              assert(openingTagEnd == element.length());
+              return {openingTagEnd, 0};
+          }
 
-      if (element[openingTagEnd - 2] == '/')
-      {   // Has form <tagName ... /> so no content.
-          assert(openingTagEnd == element.length());
-          return "";
+          size_t closingTagBegin = element.rfind("</");
+          assert(closingTagBegin != string::npos);
+
+          return {openingTagEnd, closingTagBegin-openingTagEnd};
       }
+  }
+
+  string getElementContent(string_view element)
+  {
+      std::pair<size_t,size_t> p = findContent(element);
+      return string(element.substr(p.first, p.second));
+  }
+
+  void extractElementContent(string & source, string_view elementName)
+  {
+      assert( elementExists(source,elementName) );
+      std::pair<size_t,size_t> element = findElement(source, elementName);
+      std::pair<size_t,size_t> content = findContent(string_view(source).substr(element.first, element.second));
+      source.erase(element.first + content.first + content.second);
+      source.erase(0, element.first + content.first);
+  }
 
-      size_t closingTagBegin = element.rfind("</");
-      assert(closingTagBegin != string::npos);
+  void moveElementContentToEnd(string & source, string_view elementName, string_view excludedElementName)
+  {
+      assert( elementExists(source,elementName) );
+      std::pair<size_t,size_t> element = findElement(source, elementName);
+      std::pair<size_t,size_t> content = findContent(string_view(source).substr(element.first, element.second));
+
+      // Erase the closing tag, then the excluded element (if any), then the opening tag...
+      const size_t contentBegin = element.first + content.first;
+      size_t contentEnd = contentBegin + content.second;
+      source.erase(contentEnd, element.first + element.second - contentEnd);
+      std::pair<size_t,size_t> excluded = findElement(string_view(source).substr(contentBegin, content.second), excludedElementName);
+      if (excluded.first != string::npos)
+      {
+          source.erase(contentBegin + excluded.first, excluded.second);
+          contentEnd -= excluded.second;
+      }
+      source.erase(element.first, content.first);
+      contentEnd -= content.first;
 
-      return element.substr(openingTagEnd, closingTagBegin-openingTagEnd);
+      // ...and swap the content with everything after it.
+      std::rotate(source.begin() + element.first, source.begin() + contentEnd, source.end());
   }
 
-  bool attributeExists(const string & element, const string & attributeName)
+  bool attributeExists(string_view element, string_view attributeName)
   {
       assert(element.front() == '<');
       assert(element.back()  == '>');
@@ -109,9 +152,9 @@ namespace XML
       {   // Then no attributes in this tag.
           return false;
       }
-      string attributes = element.substr(attributesBegin, attributesEnd - attributesBegin);
+      string_view attributes = element.substr(attributesBegin, attributesEnd - attributesBegin);
 
-      size_t attributeNameBegin = attributes.find(attributeName + "=\"");
+      size_t attributeNameBegin = attributes.find(string(attributeName) + "=\"");
       if (attributeNameBegin == string::npos)
       {   // Then an attribute of this name is not present in this tag.
           return false;
@@ -128,20 +171,20 @@ namespace XML
       return true;
   }
 
-  string getElementAttribute(const string & element, const string & attributeName)
+  string getElementAttribute(string_view element, string_view attributeName)
   {
       assert( attributeExists(element,attributeName) );
 
       size_t attributesBegin = element.find(" ");
       size_t attributesEnd   = element.find(">");
-      string attributes = element.substr(attributesBegin, attributesEnd - attributesBegin);
+      string_view attributes = element.substr(attributesBegin, attributesEnd - attributesBegin);
 
-      size_t attributeNameBegin = attributes.find(attributeName + "=\"");
+      size_t attributeNameBegin = attributes.find(string(attributeName) + "=\"");
 
       size_t attributeValueBegin = attributeNameBegin + attributeName.length() + 2;
       size_t attributeValueEnd   = attributes.find("\"",attributeValueBegin);
 
-      return attributes.substr(attributeValueBegin, attributeValueEnd - attributeValueBegin);
+      return string(attributes.substr(attributeValueBegin, attributeValueEnd - attributeValueBegin));
   }
  }
 }